@@ -0,0 +1,716 @@
+/* *******************************************************
+ * Filename		:	Benchmark.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	Benchmark Class Implementation
+ * ******************************************************/
+
+#include "Benchmark.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+#include "PointIndex.h"
+#include "SegmentIndex.h"
+#include "MicroBatch.h"
+#include "FeatureFusion.h"
+
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+ /**
+  * @brief Get the current time in milliseconds.
+  *
+  * @return double Milliseconds since an arbitrary starting point.
+  */
+double Benchmark::nowMs() {
+    return static_cast<double>(cv::getTickCount()) * 1000.0 / cv::getTickFrequency();
+}
+
+/**
+ * @brief Get the peak resident memory of the process.
+ *
+ * Uses the peak working set on Windows and ru_maxrss elsewhere.
+ *
+ * @return size_t The peak in bytes.
+ */
+size_t Benchmark::peakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/**
+ * @brief Fraction of reference segments matched by a candidate segment.
+ *
+ * A match needs both endpoints within the tolerance, in either orientation.
+ *
+ * @return double The match rate.
+ */
+double Benchmark::segmentMatchRate(const std::vector<cv::Vec4i>& reference, const std::vector<cv::Vec4i>& candidate, double tolerance) {
+    if (reference.empty()) {
+        return 1.0;
+    }
+
+    size_t matched = 0;
+    for (const cv::Vec4i& ref : reference) {
+        cv::Point a(ref[0], ref[1]);
+        cv::Point b(ref[2], ref[3]);
+        for (const cv::Vec4i& cand : candidate) {
+            cv::Point c(cand[0], cand[1]);
+            cv::Point d(cand[2], cand[3]);
+            bool forward = cv::norm(a - c) <= tolerance && cv::norm(b - d) <= tolerance;
+            bool backward = cv::norm(a - d) <= tolerance && cv::norm(b - c) <= tolerance;
+            if (forward || backward) {
+                ++matched;
+                break;
+            }
+        }
+    }
+    return static_cast<double>(matched) / reference.size();
+}
+
+/**
+ * @brief Compare time, memory and output of the line engines on one image.
+ *
+ * The image is preprocessed and edge-detected once, then every engine runs on the same edge map.
+ * The lean engines run before cv::HoughLinesP so that the growth of the process peak is
+ * attributed to the engine that caused it.
+ */
+void Benchmark::compareLineEngines(const std::string& filename, int repetitions, std::ostream& os) {
+    LineDetection prepared(filename);
+    prepared.commonOperations();
+
+    cv::Mat edges;
+    cv::Canny(prepared.getRGBPic(), edges, prepared.getThreshold(), prepared.getThreshold() * 3, 3);
+    const size_t edgePoints = static_cast<size_t>(cv::countNonZero(edges));
+
+    LineSegmentEngine& engine = prepared.getSegmentEngine();
+    const std::vector<LineEngine> order = { LineEngine::CompactHough, LineEngine::SegmentDetector, LineEngine::OpenCVHough };
+    const char* names[] = { "OpenCVHough", "CompactHough", "SegmentDetector" };
+
+    std::vector<std::vector<cv::Vec4i>> results(order.size());
+    os << std::left << std::setw(18) << "Engine" << std::setw(12) << "Time(ms)" << std::setw(16) << "Working(KiB)"
+        << std::setw(16) << "PeakGrowth(KiB)" << "Segments\n";
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        std::vector<cv::Vec4i>& segments = results[i];
+        size_t workingBytes = 0;
+        const size_t peakBefore = peakMemoryBytes();
+        const double start = nowMs();
+
+        for (int run = 0; run < std::max(1, repetitions); ++run) {
+            switch (order[i]) {
+            case LineEngine::CompactHough:
+                engine.detectCompactHough(edges, segments);
+                workingBytes = engine.getWorkingBytes();
+                break;
+            case LineEngine::SegmentDetector:
+                engine.detectSegments(prepared.getRGBPic(), segments);
+                workingBytes = engine.getWorkingBytes();
+                break;
+            default:
+                cv::HoughLinesP(edges, segments, engine.getRho(), engine.getTheta(), engine.getThreshold(),
+                    engine.getMinLineLength(), engine.getMaxLineGap());
+                workingBytes = LineSegmentEngine::estimateOpenCVHoughBytes(edges.size(), edgePoints, engine.getRho(), engine.getTheta());
+                break;
+            }
+        }
+
+        const double elapsed = (nowMs() - start) / std::max(1, repetitions);
+        const size_t peakAfter = peakMemoryBytes();
+        os << std::setw(18) << names[static_cast<int>(order[i])] << std::setw(12) << std::fixed << std::setprecision(2) << elapsed
+            << std::setw(16) << workingBytes / 1024 << std::setw(16) << (peakAfter - peakBefore) / 1024
+            << segments.size() << "\n";
+    }
+
+    // Match rates against cv::HoughLinesP can only be computed once the reference has run.
+    const std::vector<cv::Vec4i>& reference = results.back();
+    os << "Match rate vs OpenCVHough (3 px endpoints): CompactHough " << segmentMatchRate(reference, results[0], 3.0)
+        << ", SegmentDetector " << segmentMatchRate(reference, results[1], 3.0) << "\n";
+    os << "Compact accumulator: rho " << engine.getRho() << " px in " << engine.getRhoTiles() << " tile(s) of at most "
+        << engine.getMemoryBudget() / 1024 << " KiB" << std::endl;
+}
+
+/**
+ * @brief Fraction of reference points that have a candidate point within a tolerance.
+ *
+ * @return double The match rate.
+ */
+double Benchmark::pointMatchRate(const std::vector<cv::Point>& reference, const std::vector<cv::Point>& candidate, double tolerance) {
+    if (reference.empty()) {
+        return 1.0;
+    }
+
+    size_t matched = 0;
+    for (const cv::Point& ref : reference) {
+        for (const cv::Point& cand : candidate) {
+            if (cv::norm(ref - cand) <= tolerance) {
+                ++matched;
+                break;
+            }
+        }
+    }
+    return static_cast<double>(matched) / reference.size();
+}
+
+/**
+ * @brief Fraction of the reference segment length covered by nearby candidate segments.
+ *
+ * A candidate counts for a reference segment if both of its endpoints are within the tolerance of
+ * the reference line. It is projected onto the reference segment and the union of the projected
+ * spans is the covered length, so overlapping candidates are not counted twice.
+ *
+ * @return double The covered fraction.
+ */
+double Benchmark::segmentOverlap(const std::vector<cv::Vec4i>& reference, const std::vector<cv::Vec4i>& candidate, double tolerance) {
+    double totalLength = 0.0;
+    double coveredLength = 0.0;
+    std::vector<std::pair<double, double>> spans;
+
+    for (const cv::Vec4i& ref : reference) {
+        const cv::Point2d a(ref[0], ref[1]);
+        const cv::Point2d direction = cv::Point2d(ref[2], ref[3]) - a;
+        const double length = cv::norm(direction);
+        if (length <= 0.0) {
+            continue;
+        }
+        const cv::Point2d unit = direction * (1.0 / length);
+        totalLength += length;
+
+        spans.clear();
+        for (const cv::Vec4i& cand : candidate) {
+            const cv::Point2d p = cv::Point2d(cand[0], cand[1]) - a;
+            const cv::Point2d q = cv::Point2d(cand[2], cand[3]) - a;
+            if (std::abs(unit.cross(p)) > tolerance || std::abs(unit.cross(q)) > tolerance) {
+                continue;
+            }
+            const double s = std::max(0.0, std::min(unit.dot(p), unit.dot(q)));
+            const double t = std::min(length, std::max(unit.dot(p), unit.dot(q)));
+            if (t > s) {
+                spans.emplace_back(s, t);
+            }
+        }
+
+        // Length of the union of the spans
+        std::sort(spans.begin(), spans.end());
+        double end = 0.0;
+        for (const std::pair<double, double>& span : spans) {
+            if (span.second > end) {
+                coveredLength += span.second - std::max(span.first, end);
+                end = span.second;
+            }
+        }
+    }
+    return totalLength > 0.0 ? coveredLength / totalLength : 1.0;
+}
+
+/**
+ * @brief Repeatability of candidate corners with respect to reference corners.
+ *
+ * Every reference corner is matched to its nearest unused candidate within the tolerance. Dividing
+ * by the larger set penalizes missing and spurious corners alike.
+ *
+ * @return double The repeatability.
+ */
+double Benchmark::cornerRepeatability(const std::vector<cv::Point>& reference, const std::vector<cv::Point>& candidate, double tolerance, double& meanError) {
+    meanError = 0.0;
+    if (reference.empty() && candidate.empty()) {
+        return 1.0;
+    }
+
+    std::vector<bool> used(candidate.size(), false);
+    size_t matched = 0;
+    double errorSum = 0.0;
+    for (const cv::Point& ref : reference) {
+        int best = -1;
+        double bestDistance = tolerance;
+        for (size_t i = 0; i < candidate.size(); ++i) {
+            const double distance = cv::norm(ref - candidate[i]);
+            if (!used[i] && distance <= bestDistance) {
+                best = static_cast<int>(i);
+                bestDistance = distance;
+            }
+        }
+        if (best >= 0) {
+            used[best] = true;
+            ++matched;
+            errorSum += bestDistance;
+        }
+    }
+
+    if (matched > 0) {
+        meanError = errorSum / matched;
+    }
+    return static_cast<double>(matched) / std::max(reference.size(), candidate.size());
+}
+
+/**
+ * @brief Check the fast denoiser against the exact bilateral filter.
+ *
+ * For every image the denoise step is timed alone on the same grayscale input, then both
+ * detectors run once per denoiser and their features are matched. Corners must move at most
+ * the tolerance, line segments must have both endpoints within the tolerance.
+ */
+bool Benchmark::compareDenoisers(const std::vector<std::string>& filenames, double tolerance, double minMatchRate, std::ostream& os) {
+    bool allPassed = true;
+    os << std::left << std::setw(28) << "Image" << std::setw(16) << "Bilateral(ms)" << std::setw(16) << "FastGuided(ms)"
+        << std::setw(12) << "Lines" << std::setw(12) << "Corners" << "Result\n";
+
+    for (const std::string& filename : filenames) {
+        // Time the denoise step alone on the grayscale image commonOperations() would produce.
+        CommonProcesses prepared(filename);
+        prepared.filterNoise();
+        prepared.rescale(800, 600);
+        prepared.convertToGrays();
+        const cv::Mat gray = prepared.getRGBPic().clone();
+
+        double start = nowMs();
+        prepared.denoiseBilateralFilter();
+        const double exactMs = nowMs() - start;
+
+        prepared.setRGBPic(gray);
+        start = nowMs();
+        prepared.denoiseFastGuided();
+        const double fastMs = nowMs() - start;
+
+        std::vector<cv::Vec4i> segments[2];
+        std::vector<cv::Point> corners[2];
+        const DenoiseMode modes[] = { DenoiseMode::Bilateral, DenoiseMode::FastGuided };
+        for (int m = 0; m < 2; ++m) {
+            LineDetection lineDetection(filename);
+            lineDetection.setDenoiseMode(modes[m]);
+            lineDetection.analyzeFeatures();
+            const std::vector<std::pair<int, int>> endpoints = lineDetection.getanalyzeFeatures();
+            for (size_t i = 0; i + 1 < endpoints.size(); i += 2) {
+                segments[m].push_back(cv::Vec4i(endpoints[i].first, endpoints[i].second, endpoints[i + 1].first, endpoints[i + 1].second));
+            }
+
+            CornerDetection cornerDetection(filename);
+            cornerDetection.setDenoiseMode(modes[m]);
+            cornerDetection.analyzeFeatures();
+            for (const std::pair<int, int>& corner : cornerDetection.getanalyzeFeatures()) {
+                corners[m].push_back(cv::Point(corner.first, corner.second));
+            }
+        }
+
+        const double lineRate = segmentMatchRate(segments[0], segments[1], tolerance);
+        const double cornerRate = pointMatchRate(corners[0], corners[1], tolerance);
+        const bool passed = lineRate >= minMatchRate && cornerRate >= minMatchRate;
+        allPassed = allPassed && passed;
+
+        os << std::setw(28) << filename << std::fixed << std::setprecision(2) << std::setw(16) << exactMs << std::setw(16) << fastMs
+            << std::setw(12) << lineRate << std::setw(12) << cornerRate << (passed ? "PASS" : "FAIL") << "\n";
+    }
+
+    os << "Tolerance " << tolerance << " px, minimum match rate " << minMatchRate << ": " << (allPassed ? "PASS" : "FAIL") << std::endl;
+    return allPassed;
+}
+
+/**
+ * @brief Compare spatial index queries with linear scans.
+ *
+ * Points and short segments are spread uniformly over a 10000 x 10000 canvas. Every query kind runs
+ * with and without the index on the same query points. The sorted results of every query are
+ * compared, nearest neighbours by their distances, and the first mismatch of each kind is printed.
+ */
+bool Benchmark::compareSpatialQueries(size_t count, int queries, std::ostream& os) {
+    cv::RNG rng(12345);
+    const float canvas = 10000.0f;
+    std::vector<cv::Point2f> points(count);
+    std::vector<cv::Vec4f> segments(count);
+    for (size_t i = 0; i < count; ++i) {
+        points[i] = cv::Point2f(rng.uniform(0.0f, canvas), rng.uniform(0.0f, canvas));
+        const float x = rng.uniform(0.0f, canvas);
+        const float y = rng.uniform(0.0f, canvas);
+        segments[i] = cv::Vec4f(x, y, x + rng.uniform(-30.0f, 30.0f), y + rng.uniform(-30.0f, 30.0f));
+    }
+    std::vector<cv::Point2f> centers(std::max(1, queries));
+    for (cv::Point2f& center : centers) {
+        center = cv::Point2f(rng.uniform(0.0f, canvas), rng.uniform(0.0f, canvas));
+    }
+
+    double start = nowMs();
+    PointIndex pointIndex;
+    pointIndex.build(points);
+    SegmentIndex segmentIndex;
+    segmentIndex.build(segments);
+    os << "Built indexes over " << count << " points and " << count << " segments in " << std::fixed << std::setprecision(2)
+        << nowMs() - start << " ms, " << (pointIndex.memoryBytes() + segmentIndex.memoryBytes()) / 1024 << " KiB\n";
+    os << std::left << std::setw(26) << "Query" << std::setw(16) << "Index(us)" << std::setw(16) << "Scan(us)" << "Results(index/scan)\n";
+
+    const float radius = 50.0f;
+    const size_t k = std::min<size_t>(8, count);
+    auto distanceOf = [&](const cv::Point2f& c, int i) {
+        const float dx = points[i].x - c.x, dy = points[i].y - c.y;
+        return dx * dx + dy * dy;
+    };
+
+    bool passed = true;
+    std::vector<std::vector<int>> indexedResults(centers.size());
+    std::vector<std::vector<int>> scanResults(centers.size());
+    for (int kind = 0; kind < 4; ++kind) {
+        const char* names[] = { "corners within 50 px", "8 nearest corners", "segments in 100 px box", "segments crossing segment" };
+        size_t indexed = 0;
+        size_t scanned = 0;
+
+        start = nowMs();
+        for (size_t q = 0; q < centers.size(); ++q) {
+            const cv::Point2f& c = centers[q];
+            std::vector<int>& result = indexedResults[q];
+            switch (kind) {
+            case 0: pointIndex.queryRadius(c, radius, result); break;
+            case 1: pointIndex.nearest(c, static_cast<int>(k), result); break;
+            case 2: segmentIndex.queryBox(cv::Rect2f(c.x, c.y, 100.0f, 100.0f), result); break;
+            default: segmentIndex.queryIntersecting(cv::Vec4f(c.x, c.y, c.x + 200.0f, c.y + 50.0f), result); break;
+            }
+            indexed += result.size();
+        }
+        const double indexUs = (nowMs() - start) * 1000.0 / centers.size();
+
+        start = nowMs();
+        for (size_t q = 0; q < centers.size(); ++q) {
+            const cv::Point2f& c = centers[q];
+            std::vector<int>& result = scanResults[q];
+            result.clear();
+            if (kind == 1) {
+                // Partial selection of the k smallest distances is the best a scan can do.
+                std::vector<std::pair<float, int>> distances(count);
+                for (size_t i = 0; i < count; ++i) {
+                    distances[i] = std::make_pair(distanceOf(c, static_cast<int>(i)), static_cast<int>(i));
+                }
+                std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+                for (size_t i = 0; i < k; ++i) {
+                    result.push_back(distances[i].second);
+                }
+            }
+            else if (kind == 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (distanceOf(c, static_cast<int>(i)) <= radius * radius) {
+                        result.push_back(static_cast<int>(i));
+                    }
+                }
+            }
+            else {
+                const cv::Rect2f box(c.x, c.y, 100.0f, 100.0f);
+                const cv::Vec4f probe(c.x, c.y, c.x + 200.0f, c.y + 50.0f);
+                for (size_t i = 0; i < count; ++i) {
+                    if (kind == 2 ? SegmentIndex::intersects(segments[i], box) : SegmentIndex::intersects(segments[i], probe)) {
+                        result.push_back(static_cast<int>(i));
+                    }
+                }
+            }
+            scanned += result.size();
+        }
+        const double scanUs = (nowMs() - start) * 1000.0 / centers.size();
+
+        // Range queries must find the same ids. Nearest neighbours are compared by their sorted
+        // distances, since points at equal distance may be picked in either order.
+        size_t mismatches = 0;
+        for (size_t q = 0; q < centers.size(); ++q) {
+            std::vector<int>& a = indexedResults[q];
+            std::vector<int>& b = scanResults[q];
+            bool same;
+            if (kind == 1) {
+                std::vector<float> da, db;
+                for (int i : a) {
+                    da.push_back(distanceOf(centers[q], i));
+                }
+                for (int i : b) {
+                    db.push_back(distanceOf(centers[q], i));
+                }
+                std::sort(da.begin(), da.end());
+                std::sort(db.begin(), db.end());
+                same = da == db;
+            }
+            else {
+                std::sort(a.begin(), a.end());
+                std::sort(b.begin(), b.end());
+                same = a == b;
+            }
+            if (!same && mismatches++ == 0) {
+                os << names[kind] << ": query " << q << " at (" << centers[q].x << ", " << centers[q].y << ") found "
+                    << a.size() << " with the index and " << b.size() << " with the scan\n";
+            }
+        }
+        passed = passed && mismatches == 0;
+
+        os << std::setw(26) << names[kind] << std::setw(16) << indexUs << std::setw(16) << scanUs << indexed << "/" << scanned
+            << (mismatches ? "  MISMATCH in " + std::to_string(mismatches) + " queries" : "") << "\n";
+    }
+    os.flush();
+    return passed;
+}
+
+/**
+ * @brief Compare micro-batched detection with one image at a time on synthetic thumbnails.
+ *
+ * Every size is run three ways: the regular LineDetection and CornerDetection pipeline per image,
+ * a MicroBatch holding a single image, and a MicroBatch of batchSize images. The batched features
+ * are compared with the pipeline's features mapped back to thumbnail coordinates, which is what
+ * users get today, as segment recall and precision and corner repeatability. The last column
+ * checks that packing itself does not change anything, by comparing with the single image batch.
+ *
+ * Speedup is the single image batch time over the batched time, both at the thumbnail's own
+ * resolution, so it measures batching alone. The pipeline upscales every thumbnail to 800x600, its
+ * ratio to the batched time is shown apart as vsPipeline and mostly reflects the lower resolution.
+ */
+void Benchmark::compareMicroBatching(int imagesPerSize, int batchSize, std::ostream& os) {
+    imagesPerSize = std::max(1, imagesPerSize);
+    batchSize = std::max(1, batchSize);
+    const double tolerance = 2.0;
+    cv::RNG rng(12345);
+    os << std::left << std::setw(10) << "Size" << std::setw(14) << "Pipeline(ms)" << std::setw(12) << "Single(ms)"
+        << std::setw(13) << "Batched(ms)" << std::setw(10) << "Speedup" << std::setw(12) << "vsPipeline" << std::setw(12) << "LineRecall" << std::setw(10) << "LinePrec"
+        << std::setw(11) << "CornerRep" << std::setw(9) << "Packing" << "Buffers(KiB)\n";
+
+    for (int side : { 64, 128, 256 }) {
+        std::vector<cv::Mat> thumbnails(imagesPerSize);
+        for (cv::Mat& thumbnail : thumbnails) {
+            thumbnail.create(side, side, CV_8UC3);
+            thumbnail.setTo(cv::Scalar(rng.uniform(0, 80), rng.uniform(0, 80), rng.uniform(0, 80)));
+            for (int shape = 0; shape < 6; ++shape) {
+                const cv::Point a(rng.uniform(0, side), rng.uniform(0, side));
+                const cv::Point b(rng.uniform(0, side), rng.uniform(0, side));
+                const cv::Scalar color(rng.uniform(100, 256), rng.uniform(100, 256), rng.uniform(100, 256));
+                if (shape % 2 == 0) {
+                    cv::rectangle(thumbnail, cv::Rect(a, b), color, cv::FILLED);
+                }
+                else {
+                    cv::line(thumbnail, a, b, color, 2);
+                }
+            }
+        }
+
+        std::vector<BatchFeatures> pipeline(imagesPerSize);
+        double pipelineMs = 0.0;
+        for (int i = 0; i < imagesPerSize; ++i) {
+            double start = nowMs();
+            LineDetection lineDetector(thumbnails[i]);
+            CornerDetection cornerDetector(thumbnails[i]);
+            lineDetector.setLeanMode(true);
+            cornerDetector.setLeanMode(true);
+            lineDetector.prepare();
+            cornerDetector.adoptPreprocessing(lineDetector);
+            lineDetector.analyzeFeatures();
+            cornerDetector.analyzeFeatures();
+            pipelineMs += nowMs() - start;
+
+            // The pipeline reports features at its working resolution, map them back to the thumbnail
+            const ProcessingReport& report = lineDetector.getProcessingReport();
+            const double sx = static_cast<double>(side) / report.workingSize.width;
+            const double sy = static_cast<double>(side) / report.workingSize.height;
+            auto mapX = [sx](double x) { return (x + 0.5) * sx - 0.5; };
+            auto mapY = [sy](double y) { return (y + 0.5) * sy - 0.5; };
+            for (const cv::Vec4i& line : lineDetector.getLines()) {
+                pipeline[i].lines.push_back(cv::Vec4i(cvRound(mapX(line[0])), cvRound(mapY(line[1])),
+                    cvRound(mapX(line[2])), cvRound(mapY(line[3]))));
+            }
+            for (const cv::Point2f& corner : cornerDetector.getCorners()) {
+                pipeline[i].corners.push_back(cv::Point2f(static_cast<float>(mapX(corner.x)), static_cast<float>(mapY(corner.y))));
+            }
+        }
+        pipelineMs /= imagesPerSize;
+
+        std::vector<BatchFeatures> single(imagesPerSize);
+        std::vector<BatchFeatures> output;
+        MicroBatch one(cv::Size(side, side), 1);
+        double start = nowMs();
+        for (int i = 0; i < imagesPerSize; ++i) {
+            one.clear();
+            one.add(thumbnails[i]);
+            one.process(output);
+            single[i] = output.front();
+        }
+        const double singleMs = (nowMs() - start) / imagesPerSize;
+
+        std::vector<BatchFeatures> batched;
+        batched.reserve(imagesPerSize);
+        MicroBatch batch(cv::Size(side, side), batchSize);
+        start = nowMs();
+        for (int first = 0; first < imagesPerSize; first += batchSize) {
+            batch.clear();
+            for (int i = first; i < std::min(imagesPerSize, first + batchSize); ++i) {
+                batch.add(thumbnails[i]);
+            }
+            batch.process(output);
+            batched.insert(batched.end(), output.begin(), output.end());
+        }
+        const double batchedMs = (nowMs() - start) / imagesPerSize;
+
+        double lineRecall = 0.0;
+        double linePrecision = 0.0;
+        double repeatability = 0.0;
+        double packing = 0.0;
+        for (int i = 0; i < imagesPerSize; ++i) {
+            const std::vector<cv::Point> reference(pipeline[i].corners.begin(), pipeline[i].corners.end());
+            const std::vector<cv::Point> alone(single[i].corners.begin(), single[i].corners.end());
+            const std::vector<cv::Point> candidate(batched[i].corners.begin(), batched[i].corners.end());
+            double meanError = 0.0;
+            lineRecall += segmentOverlap(pipeline[i].lines, batched[i].lines, tolerance);
+            linePrecision += segmentOverlap(batched[i].lines, pipeline[i].lines, tolerance);
+            repeatability += cornerRepeatability(reference, candidate, tolerance, meanError);
+            packing += std::min(segmentOverlap(single[i].lines, batched[i].lines, 0.0),
+                cornerRepeatability(alone, candidate, 0.0, meanError));
+        }
+
+        os << std::setw(10) << (std::to_string(side) + "x" + std::to_string(side)) << std::fixed << std::setprecision(3)
+            << std::setw(14) << pipelineMs << std::setw(12) << singleMs << std::setw(13) << batchedMs
+            << std::setprecision(2) << std::setw(10) << singleMs / std::max(batchedMs, 1e-9)
+            << std::setw(12) << pipelineMs / std::max(batchedMs, 1e-9)
+            << std::setw(12) << lineRecall / imagesPerSize << std::setw(10) << linePrecision / imagesPerSize
+            << std::setw(11) << repeatability / imagesPerSize << std::setw(9) << packing / imagesPerSize
+            << batch.memoryBytes() / 1024 << "\n";
+    }
+    os.flush();
+}
+
+/**
+ * @brief Check and time the indexed junction extraction against the brute-force pairwise test.
+ *
+ * Half of the segments are placed against a random corner: ending inside the radius, passing
+ * through it, running through it and overshooting it by less than the radius, or passing it just
+ * outside the radius. They should give one, two, one and no ray at that corner. The other half are
+ * random clutter. Both methods run with a minimum of one ray so every incidence is compared.
+ */
+bool Benchmark::compareJunctions(size_t lines, size_t corners, int repetitions, std::ostream& os) {
+    lines = std::max<size_t>(1, lines);
+    corners = std::max<size_t>(1, corners);
+    repetitions = std::max(1, repetitions);
+    const float radius = 3.0f;
+    const float canvas = 40.0f * std::sqrt(static_cast<float>(lines));
+    cv::RNG rng(12345);
+
+    std::vector<cv::Point2f> cornerPoints(corners);
+    for (cv::Point2f& corner : cornerPoints) {
+        corner = cv::Point2f(rng.uniform(0.0f, canvas), rng.uniform(0.0f, canvas));
+    }
+
+    const char* caseNames[] = { "ending inside", "passing through", "overshooting", "missing" };
+    const int expectedRays[] = { 1, 2, 1, 0 };
+    std::vector<cv::Vec4f> segments(lines);
+    std::vector<int> placedCorner(lines, -1);
+    std::vector<int> placedCase(lines, -1);
+    for (size_t i = 0; i < lines; ++i) {
+        const float angle = rng.uniform(0.0f, static_cast<float>(2.0 * CV_PI));
+        const cv::Point2f direction(std::cos(angle), std::sin(angle));
+        const cv::Point2f normal(-direction.y, direction.x);
+        const float length = rng.uniform(10.0f, 80.0f);
+        if (i % 2 == 1) {
+            const cv::Point2f a(rng.uniform(0.0f, canvas), rng.uniform(0.0f, canvas));
+            const cv::Point2f b = a + direction * length;
+            segments[i] = cv::Vec4f(a.x, a.y, b.x, b.y);
+            continue;
+        }
+
+        const int corner = rng.uniform(0, static_cast<int>(corners));
+        const cv::Point2f& c = cornerPoints[corner];
+        const int kind = static_cast<int>((i / 2) % 4);
+        cv::Point2f a, b;
+        switch (kind) {
+        case 0:
+            a = c + cv::Point2f(rng.uniform(-0.7f, 0.7f), rng.uniform(-0.7f, 0.7f)) * radius;
+            b = a + direction * length;
+            break;
+        case 1:
+            a = c + normal * (rng.uniform(-0.9f, 0.9f) * radius) - direction * length;
+            b = a + direction * (length + rng.uniform(10.0f, 80.0f));
+            break;
+        case 2:
+            a = c - direction * length;
+            b = c + direction * (rng.uniform(0.1f, 0.9f) * radius);
+            break;
+        default:
+            a = c + normal * (rng.uniform(1.05f, 1.5f) * radius) - direction * length;
+            b = a + direction * (2.0f * length);
+            break;
+        }
+        segments[i] = cv::Vec4f(a.x, a.y, b.x, b.y);
+        placedCorner[i] = corner;
+        placedCase[i] = kind;
+    }
+
+    std::vector<Junction> indexed;
+    double start = nowMs();
+    for (int r = 0; r < repetitions; ++r) {
+        indexed = FeatureFusion::extractJunctions(segments, cornerPoints, radius, 1);
+    }
+    const double indexedMs = (nowMs() - start) / repetitions;
+
+    std::vector<Junction> bruteForce;
+    start = nowMs();
+    for (int r = 0; r < repetitions; ++r) {
+        bruteForce = FeatureFusion::extractJunctionsBruteForce(segments, cornerPoints, radius, 1);
+    }
+    const double bruteForceMs = (nowMs() - start) / repetitions;
+
+    auto countRays = [](const std::vector<Junction>& junctions) {
+        size_t rays = 0;
+        for (const Junction& junction : junctions) {
+            rays += junction.segments.size();
+        }
+        return rays;
+    };
+    os << "Junctions of " << corners << " corners and " << lines << " segments within " << radius << " px\n";
+    os << std::left << std::setw(14) << "Method" << std::setw(12) << "Time(ms)" << std::setw(12) << "Junctions" << "Rays\n";
+    os << std::setw(14) << "Indexed" << std::setw(12) << std::fixed << std::setprecision(2) << indexedMs << std::setw(12) << indexed.size() << countRays(indexed) << "\n";
+    os << std::setw(14) << "Brute force" << std::setw(12) << bruteForceMs << std::setw(12) << bruteForce.size() << countRays(bruteForce) << "\n";
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < std::max(indexed.size(), bruteForce.size()); ++i) {
+        const bool same = i < indexed.size() && i < bruteForce.size() && indexed[i].corner == bruteForce[i].corner &&
+            indexed[i].segments == bruteForce[i].segments && indexed[i].directions == bruteForce[i].directions;
+        if (!same && mismatches++ == 0) {
+            os << "First mismatch at junction " << i << ": corner "
+                << (i < indexed.size() ? std::to_string(indexed[i].corner) : "-") << " indexed, "
+                << (i < bruteForce.size() ? std::to_string(bruteForce[i].corner) : "-") << " brute force\n";
+        }
+    }
+    os << "Indexed matches brute force: " << (mismatches == 0 ? "yes" : "no, " + std::to_string(mismatches) + " junctions differ") << "\n";
+    bool passed = mismatches == 0;
+
+    std::vector<int> junctionOf(corners, -1);
+    for (size_t i = 0; i < indexed.size(); ++i) {
+        junctionOf[indexed[i].corner] = static_cast<int>(i);
+    }
+    int placed[4] = { 0, 0, 0, 0 };
+    int correct[4] = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < lines; ++i) {
+        if (placedCase[i] < 0) {
+            continue;
+        }
+        int found = 0;
+        if (junctionOf[placedCorner[i]] >= 0) {
+            const std::vector<int>& ids = indexed[junctionOf[placedCorner[i]]].segments;
+            found = static_cast<int>(std::count(ids.begin(), ids.end(), static_cast<int>(i)));
+        }
+        ++placed[placedCase[i]];
+        correct[placedCase[i]] += found == expectedRays[placedCase[i]] ? 1 : 0;
+    }
+    for (int kind = 0; kind < 4; ++kind) {
+        os << std::setw(18) << caseNames[kind] << correct[kind] << "/" << placed[kind] << " with " << expectedRays[kind] << " ray(s)\n";
+        passed = passed && correct[kind] == placed[kind];
+    }
+    os.flush();
+    return passed;
+}
@@ -0,0 +1,112 @@
+/* *******************************************************
+ * Filename		:	Benchmark.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	Benchmark Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief Benchmark class with timing and memory helpers used to compare pipeline variants.
+  */
+class Benchmark {
+public:
+    /**
+     * @brief Get the current time in milliseconds from OpenCV's tick counter.
+     * @return The time in milliseconds.
+     */
+    static double nowMs();
+
+    /**
+     * @brief Get the peak resident memory of the process so far.
+     * @return The peak in bytes, 0 if the platform does not report it.
+     */
+    static size_t peakMemoryBytes();
+
+    /**
+     * @brief Fraction of reference segments matched by a candidate segment with both endpoints within a tolerance.
+     * @param reference The reference segments.
+     * @param candidate The segments to be checked.
+     * @param tolerance Maximum endpoint distance in pixels.
+     * @return The match rate in [0, 1], 1 when the reference is empty.
+     */
+    static double segmentMatchRate(const std::vector<cv::Vec4i>& reference, const std::vector<cv::Vec4i>& candidate, double tolerance);
+
+    /**
+     * @brief Fraction of reference points that have a candidate point within a tolerance.
+     * @param reference The reference points.
+     * @param candidate The points to be checked.
+     * @param tolerance Maximum distance in pixels.
+     * @return The match rate in [0, 1], 1 when the reference is empty.
+     */
+    static double pointMatchRate(const std::vector<cv::Point>& reference, const std::vector<cv::Point>& candidate, double tolerance);
+
+    /**
+     * @brief Fraction of the reference segment length covered by candidate segments lying within a tolerance of it.
+     * @param reference The reference segments.
+     * @param candidate The segments to be checked.
+     * @param tolerance Maximum perpendicular distance of both candidate endpoints from the reference line in pixels.
+     * @return The covered fraction in [0, 1], 1 when the reference is empty.
+     */
+    static double segmentOverlap(const std::vector<cv::Vec4i>& reference, const std::vector<cv::Vec4i>& candidate, double tolerance);
+
+    /**
+     * @brief Repeatability of candidate corners with respect to reference corners.
+     * @param reference The reference corners.
+     * @param candidate The corners to be checked.
+     * @param tolerance Maximum distance of a matched pair in pixels.
+     * @param meanError Set to the mean distance of the matched pairs, 0 if nothing matched.
+     * @return Matched pairs divided by the size of the larger set, 1 when both are empty.
+     */
+    static double cornerRepeatability(const std::vector<cv::Point>& reference, const std::vector<cv::Point>& candidate, double tolerance, double& meanError);
+
+    /**
+     * @brief Check that the fast denoiser keeps lines and corners within a tolerance of the exact bilateral filter.
+     * @param filenames The reference image set.
+     * @param tolerance Maximum feature displacement in pixels.
+     * @param minMatchRate Minimum fraction of features that must be reproduced for an image to pass.
+     * @param os The stream the report is written to.
+     * @return True if every image passes.
+     */
+    static bool compareDenoisers(const std::vector<std::string>& filenames, double tolerance, double minMatchRate, std::ostream& os);
+
+    /**
+     * @brief Compare time, memory and output of the line engines on one image.
+     * @param filename The image to be processed.
+     * @param repetitions Number of timed runs per engine.
+     * @param os The stream the report is written to.
+     */
+    static void compareLineEngines(const std::string& filename, int repetitions, std::ostream& os);
+
+    /**
+     * @brief Compare spatial index queries with linear scans on random points and segments.
+     * @param count Number of points and of segments.
+     * @param queries Number of queries of each kind.
+     * @param os The stream the report is written to.
+     * @return True if the index and the scan agree on every query.
+     */
+    static bool compareSpatialQueries(size_t count, int queries, std::ostream& os);
+
+    /**
+     * @brief Compare micro-batched detection with one image at a time on synthetic thumbnails.
+     * @param imagesPerSize Number of thumbnails of every size.
+     * @param batchSize Number of thumbnails per batch.
+     * @param os The stream the report is written to.
+     */
+    static void compareMicroBatching(int imagesPerSize, int batchSize, std::ostream& os);
+
+    /**
+     * @brief Check and time the indexed junction extraction against the brute-force pairwise test.
+     * @param lines Number of segments.
+     * @param corners Number of corners.
+     * @param repetitions Number of timed runs per method.
+     * @param os The stream the report is written to.
+     * @return True if both methods give the same junctions and every placed segment has its expected rays.
+     */
+    static bool compareJunctions(size_t lines, size_t corners, int repetitions, std::ostream& os);
+};
@@ -6,27 +6,76 @@
  * ******************************************************/
 
 #include "CommonProcesses.h"
+#include "ParallelLoop.h"
+
+#include <algorithm>
 
  /**
   * @brief Constructor that takes the filename of an image and reads the image.
   * @param filename The filename of the image to be read.
   * @throws std::runtime_error if the image cannot be opened or has an unsupported number of channels.
   */
-CommonProcesses::CommonProcesses(const std::string& filename) {
+CommonProcesses::CommonProcesses(const std::string& filename) : denoiseMode(DenoiseMode::Bilateral) {
     readRGBFromFile(filename);
 }
 
+/**
+ * @brief Constructor that takes an already decoded image.
+ * @param image The image to be processed.
+ * @throws std::runtime_error if the image is empty or has an unsupported number of channels.
+ */
+CommonProcesses::CommonProcesses(const cv::Mat& image) : denoiseMode(DenoiseMode::Bilateral) {
+    setRGBPic(toSupportedImage(image, "decoded image"));
+}
+
+/**
+ * @brief Validates an input image and brings it to 8 bits per channel.
+ *
+ * 16-bit images are scaled down to 8 bits and floating point images, taken to lie in [0, 1], are
+ * scaled and saturated to 8 bits. 1- and 3-channel layouts are kept as they are so that the
+ * pipeline can run the matching specialization. The alpha channel of 4-channel images is dropped,
+ * as the file decoder does, so that in-memory images take the same path as files.
+ *
+ * @param image The decoded image.
+ * @param source Name of the image used in error messages.
+ * @return cv::Mat The 8-bit image.
+ * @throws std::runtime_error if the image is empty or has an unsupported depth or number of channels.
+ */
+cv::Mat CommonProcesses::toSupportedImage(const cv::Mat& image, const std::string& source) {
+    if (image.empty() || (image.channels() != 1 && image.channels() != 3 && image.channels() != 4)) {
+        throw std::runtime_error("Could not open or find the image, or the number of channels is not supported: " + source);
+    }
+    cv::Mat converted = image;
+    if (image.channels() == 4) {
+        cv::cvtColor(image, converted, cv::COLOR_BGRA2BGR);
+    }
+    if (converted.depth() == CV_8U) {
+        return converted;
+    }
+    if (converted.depth() == CV_16U) {
+        converted.convertTo(converted, CV_8U, 1.0 / 257.0);
+    }
+    else if (converted.depth() == CV_32F || converted.depth() == CV_64F) {
+        converted.convertTo(converted, CV_8U, 255.0);
+    }
+    else {
+        throw std::runtime_error("The pixel depth is not supported: " + source);
+    }
+    return converted;
+}
+
 /**
  * @brief Reads an RGB image from a file.
+ *
+ * Grayscale files are not expanded to BGR by the decoder and the EXIF orientation is applied,
+ * see imageReadFlags.
+ *
  * @param filename The filename of the image to be read.
  * @throws std::runtime_error if the image cannot be opened or has an unsupported number of channels.
  */
 void CommonProcesses::readRGBFromFile(const std::string& filename) {
-    cv::Mat image = cv::imread(filename, cv::IMREAD_COLOR);
-    if (image.empty() || (image.channels() != 3 && image.channels() != 4)) {
-        throw std::runtime_error("Could not open or find the image, or the number of channels is not supported: " + filename);
-    }
-    setRGBPic(image);
+    cv::Mat image = cv::imread(filename, imageReadFlags);
+    setRGBPic(toSupportedImage(image, filename));
 }
 
 /**
@@ -38,6 +87,43 @@ void CommonProcesses::setRGBPic(const cv::Mat& data) {
     RGBPic = data.clone();
 }
 
+/**
+ * @brief Uses a working image prepared by another object, sharing its pixel data.
+ * @param working The prepared working image.
+ */
+void CommonProcesses::shareWorkingImage(const cv::Mat& working) {
+    RGBPic = working;
+}
+
+/**
+ * @brief Releases the working image and the original copy.
+ */
+void CommonProcesses::releaseImages() {
+    RGBPic.release();
+    orginalPic.release();
+}
+
+/**
+ * @brief Number of bytes of pixel data referenced by a matrix.
+ * @param mat The matrix.
+ * @return size_t The number of bytes.
+ */
+size_t CommonProcesses::matBytes(const cv::Mat& mat) {
+    return mat.empty() ? 0 : mat.total() * mat.elemSize();
+}
+
+/**
+ * @brief Gets the number of bytes held by this object.
+ *
+ * Counts the object itself and the pixel data of its images. Buffers shared with other
+ * objects are counted by each of them.
+ *
+ * @return size_t The memory footprint in bytes.
+ */
+size_t CommonProcesses::memoryFootprint() const {
+    return sizeof(CommonProcesses) + matBytes(RGBPic) + matBytes(orginalPic);
+}
+
 /**
  * @brief Gets the RGB image data.
  * @return The RGB image data.
@@ -59,7 +145,7 @@ const cv::Mat& CommonProcesses::getOrginalPic() const {
  */
 void CommonProcesses::filterNoise() {
     cv::Mat result;
-    cv::GaussianBlur(RGBPic, result, cv::Size(5, 5), 1.5);
+    cv::GaussianBlur(RGBPic, result, cv::Size(blurKernelSize, blurKernelSize), blurSigma);
     RGBPic = result;
 }
 
@@ -68,10 +154,102 @@ void CommonProcesses::filterNoise() {
  */
 void CommonProcesses::denoiseBilateralFilter() {
     cv::Mat denoisedImage;
-    cv::bilateralFilter(RGBPic, denoisedImage, 9, 75, 75);
+    cv::bilateralFilter(RGBPic, denoisedImage, bilateralDiameter, bilateralSigma, bilateralSigma);
     RGBPic = denoisedImage;
 }
 
+/**
+ * @brief Denoises the image using a fast guided filter.
+ *
+ * Approximates the d = 9 bilateral filter with the image as its own guide (He and Sun, "Fast Guided
+ * Filter"). The local linear coefficients are computed on a copy downsampled by 4, where the 9x9
+ * window shrinks to 3x3, and are upsampled bilinearly. The final per-pixel pass reads the 8-bit input
+ * directly and runs on OpenCV's thread pool, so the full-resolution work is one multiply-add per pixel.
+ */
+void CommonProcesses::denoiseFastGuided() {
+    const int subsample = 4;
+    const int radius = 4;                                   // Same window as the bilateral filter's d = 9
+    const double eps = 0.25 * 75.0 * 75.0;                  // Derived from the bilateral sigmaColor of 75
+
+    if (RGBPic.channels() != 1) {
+        throw std::runtime_error("Fast guided denoising expects a grayscale image");
+    }
+
+    cv::Mat source = RGBPic;
+    cv::Size lowSize(std::max(1, source.cols / subsample), std::max(1, source.rows / subsample));
+    const int lowRadius = std::max(1, radius / subsample);
+    const cv::Size window(2 * lowRadius + 1, 2 * lowRadius + 1);
+
+    cv::Mat low, lowSquared, mean, meanSquared;
+    cv::resize(source, low, lowSize, 0, 0, cv::INTER_AREA);
+    low.convertTo(low, CV_32F);
+    cv::multiply(low, low, lowSquared);
+    cv::boxFilter(low, mean, CV_32F, window);
+    cv::boxFilter(lowSquared, meanSquared, CV_32F, window);
+
+    // a = var / (var + eps), b = mean - a * mean, both averaged over the window again.
+    cv::Mat a(lowSize, CV_32F), b(lowSize, CV_32F);
+    for (int y = 0; y < lowSize.height; ++y) {
+        const float* m = mean.ptr<float>(y);
+        const float* m2 = meanSquared.ptr<float>(y);
+        float* ar = a.ptr<float>(y);
+        float* br = b.ptr<float>(y);
+        for (int x = 0; x < lowSize.width; ++x) {
+            float variance = std::max(0.0f, m2[x] - m[x] * m[x]);
+            ar[x] = variance / (variance + static_cast<float>(eps));
+            br[x] = m[x] - ar[x] * m[x];
+        }
+    }
+    cv::boxFilter(a, a, CV_32F, window);
+    cv::boxFilter(b, b, CV_32F, window);
+
+    cv::Mat aFull, bFull;
+    cv::resize(a, aFull, source.size(), 0, 0, cv::INTER_LINEAR);
+    cv::resize(b, bFull, source.size(), 0, 0, cv::INTER_LINEAR);
+
+    cv::Mat result(source.size(), CV_8UC1);
+    ParallelLoop::run(cv::Range(0, source.rows), [&](const cv::Range& rows) {
+        for (int y = rows.start; y < rows.end; ++y) {
+            const uchar* in = source.ptr<uchar>(y);
+            const float* ar = aFull.ptr<float>(y);
+            const float* br = bFull.ptr<float>(y);
+            uchar* out = result.ptr<uchar>(y);
+            for (int x = 0; x < source.cols; ++x) {
+                out[x] = cv::saturate_cast<uchar>(ar[x] * in[x] + br[x]);
+            }
+        }
+    });
+    RGBPic = result;
+}
+
+/**
+ * @brief Denoises the image with the selected denoiser.
+ */
+void CommonProcesses::denoise() {
+    if (denoiseMode == DenoiseMode::FastGuided) {
+        denoiseFastGuided();
+    }
+    else {
+        denoiseBilateralFilter();
+    }
+}
+
+/**
+ * @brief Sets the denoiser used by denoise().
+ * @param mode The denoise mode.
+ */
+void CommonProcesses::setDenoiseMode(DenoiseMode mode) {
+    denoiseMode = mode;
+}
+
+/**
+ * @brief Gets the denoiser used by denoise().
+ * @return The denoise mode.
+ */
+DenoiseMode CommonProcesses::getDenoiseMode() const {
+    return denoiseMode;
+}
+
 /**
  * @brief Rescales the image to the specified width and height.
  * @param width The target width for rescaling.
@@ -85,9 +263,40 @@ void CommonProcesses::rescale(int width, int height) {
 
 /**
  * @brief Converts the image to grayscale.
+ *
+ * Dispatches once on the pixel format to the matching specialization.
  */
 void CommonProcesses::convertToGrays() {
-    cv::Mat result;
-    cv::cvtColor(RGBPic, result, cv::COLOR_BGR2GRAY);
-    RGBPic = result;
+    switch (pixelFormatOf(RGBPic)) {
+    case PixelFormat::Gray8:
+        convertToGraysAs<PixelFormat::Gray8>();
+        break;
+    default:
+        convertToGraysAs<PixelFormat::BGR8>();
+        break;
+    }
+}
+
+/**
+ * @brief Converts the image to grayscale with the channel layout fixed at compile time.
+ *
+ * Grayscale images are kept as they are and BGR images go through cv::cvtColor, whose vectorized
+ * conversion is faster than a plain per-pixel loop.
+ *
+ * @throws std::runtime_error if the image does not have the expected pixel format.
+ */
+template<PixelFormat Format>
+void CommonProcesses::convertToGraysAs() {
+    if (pixelFormatOf(RGBPic) != Format) {
+        throw std::runtime_error("The image does not match the requested pixel format");
+    }
+    if constexpr (Format == PixelFormat::BGR8) {
+        cv::Mat result;
+        cv::cvtColor(RGBPic, result, cv::COLOR_BGR2GRAY);
+        RGBPic = result;
+    }
 }
+
+// Per-format instances of the grayscale conversion.
+template void CommonProcesses::convertToGraysAs<PixelFormat::Gray8>();
+template void CommonProcesses::convertToGraysAs<PixelFormat::BGR8>();
@@ -6,27 +6,93 @@
  * ******************************************************/
 
 #pragma once
+#include "PixelFormat.h"
 #include <opencv2/opencv.hpp>
 #include <memory>
 #include <string>
 
+/**
+ * @brief Edge-preserving denoisers selectable for the last preprocessing step.
+ */
+enum class DenoiseMode {
+    Bilateral,      ///< Exact cv::bilateralFilter with d = 9
+    FastGuided      ///< Self-guided filter computed on a downsampled image
+};
+
 class CommonProcesses {
 private:
     cv::Mat RGBPic;        ///< Original raw RGB image data
     cv::Mat orginalPic;    ///< Cloned copy of the original image
+    DenoiseMode denoiseMode;    ///< Denoiser used by denoise()
+
+    /**
+     * @brief Validate an input image and bring it to 8 bits per channel.
+     * @param image The decoded image.
+     * @param source Name of the image used in error messages.
+     * @return The 8-bit image, sharing data with the input when no conversion is needed.
+     */
+    static cv::Mat toSupportedImage(const cv::Mat& image, const std::string& source);
+
+protected:
+    /**
+     * @brief Release the working image and the original copy.
+     */
+    void releaseImages();
+
+    /**
+     * @brief Number of bytes of pixel data referenced by a matrix.
+     * @param mat The matrix.
+     * @return The number of bytes, 0 for an empty matrix.
+     */
+    static size_t matBytes(const cv::Mat& mat);
+
+    /**
+     * @brief Use a working image prepared by another object without copying it.
+     *
+     * Every processing step writes to a new buffer, so the shared pixel data is never modified in place.
+     *
+     * @param working The prepared working image.
+     */
+    void shareWorkingImage(const cv::Mat& working);
 
 public:
+    static constexpr int blurKernelSize = 5;        ///< Kernel size of the Gaussian blur in filterNoise()
+    static constexpr double blurSigma = 1.5;        ///< Sigma of the Gaussian blur in filterNoise()
+    static constexpr int bilateralDiameter = 9;     ///< Neighbourhood diameter of the bilateral denoiser
+    static constexpr double bilateralSigma = 75.0;  ///< Colour and space sigma of the bilateral denoiser
+
+    /**
+     * @brief Flags used to decode image files.
+     *
+     * Grayscale and 16-bit files keep their layout and depth, and unlike IMREAD_UNCHANGED the decoder
+     * still applies the EXIF orientation. Alpha channels are dropped, so files never reach the pipeline
+     * with four channels.
+     */
+    static const int imageReadFlags = cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH;
+
     /**
      * @brief Constructor that takes the filename of an image and reads the image.
      * @param filename of the image to be processed.
      */
     CommonProcesses(const std::string& filename);
 
+    /**
+     * @brief Constructor that takes an already decoded image.
+     * @param image The 1-, 3- or 4-channel image to be processed, alpha is dropped.
+     */
+    CommonProcesses(const cv::Mat& image);
+
     /**
      * @brief Destructor.
      */
     virtual ~CommonProcesses() {}
 
+    /**
+     * @brief Get the number of bytes held by this object, including image buffers and feature containers.
+     * @return The memory footprint in bytes.
+     */
+    virtual size_t memoryFootprint() const;
+
     /**
      * @brief read an RGB image from a file.
      * @param filename of the image to be read.
@@ -63,12 +129,42 @@ public:
     void rescale(int width, int height);
 
     /**
-     * @brief convert the image to grayscale.
+     * @brief convert the image to grayscale, dispatching once on the pixel format.
      */
     void convertToGrays();
 
+    /**
+     * @brief convert the image to grayscale with the channel layout fixed at compile time.
+     *
+     * Instances exist for every PixelFormat.
+     */
+    template<PixelFormat Format>
+    void convertToGraysAs();
+
     /**
      * @brief denoise the image using bilateral filtering.
      */
     void denoiseBilateralFilter();
+
+    /**
+     * @brief denoise the image using a fast guided filter computed on a downsampled copy.
+     */
+    void denoiseFastGuided();
+
+    /**
+     * @brief denoise the image with the selected denoiser.
+     */
+    void denoise();
+
+    /**
+     * @brief Select the denoiser used by denoise().
+     * @param mode The denoise mode.
+     */
+    void setDenoiseMode(DenoiseMode mode);
+
+    /**
+     * @brief Get the denoiser used by denoise().
+     * @return The denoise mode.
+     */
+    DenoiseMode getDenoiseMode() const;
 };
\ No newline at end of file
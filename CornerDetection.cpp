@@ -12,7 +12,12 @@
 #include "Detection.h"
 
  // Constructor that takes the filename of an image and initializes default parameters.
-CornerDetection::CornerDetection(const std::string& filename) : Detection(filename), qualityLevel(0.01), minDistance(10), blockSize(3), useHarrisDetector(false), k(0.04) {}
+CornerDetection::CornerDetection(const std::string& filename) : Detection(filename), qualityLevel(defaultQualityLevel),
+    minDistance(defaultMinDistance), blockSize(defaultBlockSize), useHarrisDetector(defaultUseHarrisDetector), k(defaultK) {}
+
+// Constructor that takes an already decoded image and initializes default parameters.
+CornerDetection::CornerDetection(const cv::Mat& image) : Detection(image), qualityLevel(defaultQualityLevel),
+    minDistance(defaultMinDistance), blockSize(defaultBlockSize), useHarrisDetector(defaultUseHarrisDetector), k(defaultK) {}
 
 /** Set the quality level for corner detection using the Shi-Tomasi method.
  *  The quality level is a parameter specifying the minimal accepted quality of corners.
@@ -64,6 +69,21 @@ void CornerDetection::setUseHarrisDetector(bool useHarris)
     k = kValue;
 }
 
+// Get the spatial index over the detected corners, available when it was enabled before the analysis.
+const PointIndex& CornerDetection::getPointIndex() const
+{
+    if (!isSpatialIndexEnabled()) {
+        throw std::logic_error("Spatial index is disabled, call setSpatialIndex(true) before analyzeFeatures()");
+    }
+    return cornerIndex;
+}
+
+// Get the detected corners in working-resolution coordinates.
+const std::vector<cv::Point2f>& CornerDetection::getCorners() const
+{
+    return corners;
+}
+
 //  perform corner detection using the Shi-Tomasi method.
 void CornerDetection::analyzeFeatures()
 {
@@ -71,24 +91,49 @@ void CornerDetection::analyzeFeatures()
     commonOperations();
 
     // Perform corner detection using the Shi-Tomasi method
-    cv::goodFeaturesToTrack(getRGBPic(), corners, 200, qualityLevel, minDistance, cv::Mat(), blockSize, useHarrisDetector, k);
+    cv::goodFeaturesToTrack(getRGBPic(), corners, maxCorners, qualityLevel, minDistance, cv::Mat(), blockSize, useHarrisDetector, k);
+
+    // Index the corners in the coordinates getanalyzeFeatures() reports
+    std::vector<cv::Point2f> indexed;
+    if (isSpatialIndexEnabled()) {
+        indexed.reserve(corners.size());
+        for (const cv::Point2f& corner : corners) {
+            indexed.push_back(toFeatureCoordinates(corner));
+        }
+    }
+    cornerIndex.build(indexed);
 
-    // Create an output image and convert it to BGR for visualization
-    output = getRGBPic().clone();
-    cv::cvtColor(output, output, cv::COLOR_GRAY2BGR);
+    // The output image is rendered on demand
+    {
+        std::lock_guard<RenderMutex> lock(renderMutex);
+        output.release();
+    }
 
-    // Visualize the detected corners on the output image
-    for (const cv::Point2f& corner : corners) {
-        cv::circle(output, corner, 5, cv::Scalar(0, 255, 0), -1);
+    finishProcessing();
+}
+
+/** Render the output image on the first request after analyzeFeatures(). The caller holds renderMutex.
+ *  @return False if the working image was released in lean mode.
+ */
+bool CornerDetection::renderOutput() const
+{
+    if (output.empty()) {
+        if (getRGBPic().empty()) {
+            return false;
+        }
+        output = OverlayRenderer::render(getRGBPic(), OverlayRenderer::Corners, std::vector<cv::Vec4i>(), corners);
     }
+    return true;
 }
 
 /** Get the output image with visualized corner features.
- *  @return A clone of the output image with corners visualized.
+ *  @return A clone of the output image with corners visualized, empty in lean mode.
  */cv::Mat CornerDetection::getOutputImage() const
  {
-
-
+    std::lock_guard<RenderMutex> lock(renderMutex);
+    if (!renderOutput()) {
+        return cv::Mat();
+    }
     return output.clone();
 }
 
@@ -97,15 +142,51 @@ std::vector<std::pair<int, int>> CornerDetection::getanalyzeFeatures() const {
     std::vector<std::pair<int, int>> coordList;
     for (const cv::Point2f& corner : corners) {
         // emplace_back, unlike push_back, directly constructs the element in the memory of the vector without copying existing elements in the vector.
-        coordList.emplace_back(static_cast<int>(corner.x), static_cast<int>(corner.y));
+        cv::Point2d mapped = toFeatureCoordinates(corner);
+        coordList.emplace_back(static_cast<int>(mapped.x), static_cast<int>(mapped.y));
     }
     return coordList;
 }
 
 
+// Copy this detector with its parameters, used to run the cost model probe on.
+std::unique_ptr<Detection> CornerDetection::cloneDetector() const
+{
+    return std::unique_ptr<Detection>(new CornerDetection(*this));
+}
+
+// Name the cost model of this detector's configuration: the base name and the corner parameters.
+std::string CornerDetection::costModelKey() const
+{
+    return Detection::costModelKey() + " quality=" + std::to_string(qualityLevel) + " distance=" + std::to_string(minDistance) +
+        " block=" + std::to_string(blockSize) + " harris=" + (useHarrisDetector ? "1" : "0") + " k=" + std::to_string(k);
+}
+
+// Release the images, keeping the detected corners.
+void CornerDetection::releaseIntermediates()
+{
+    {
+        std::lock_guard<RenderMutex> lock(renderMutex);
+        output.release();
+    }
+    corners.shrink_to_fit();
+    Detection::releaseIntermediates();
+}
+
+// Number of bytes held by this object: the base footprint plus the output image and the corner list.
+size_t CornerDetection::memoryFootprint() const
+{
+    return Detection::memoryFootprint() + sizeof(CornerDetection) - sizeof(CommonProcesses) +
+        matBytes(output) + corners.capacity() * sizeof(cv::Point2f) + cornerIndex.memoryBytes();
+}
+
 // Method to visualize detected corners.
 void CornerDetection::plotFeatures() const
 {
+    std::lock_guard<RenderMutex> lock(renderMutex);
+    if (!renderOutput()) {
+        throw std::runtime_error("No corner image to plot, run analyzeFeatures() without lean mode first");
+    }
     // Display the image with visualized corners
     cv::imshow("Detected Corners", output);
     cv::waitKey();
@@ -121,7 +202,8 @@ std::ostream& operator<<(std::ostream& os, const CornerDetection& cd)
 
     for (size_t i = 0; i < cd.corners.size(); ++i) {
         os << "Corner " << i + 1 << ":\n";
-        os << "  Coordinates: (" << cd.corners[i].x << ", " << cd.corners[i].y << ")\n";
+        cv::Point2d mapped = cd.toFeatureCoordinates(cd.corners[i]);
+        os << "  Coordinates: (" << mapped.x << ", " << mapped.y << ")\n";
         os << "-------------------------\n";
     }
     os << "Number of Corners: " << cd.corners.size() << "\n";
@@ -8,27 +8,65 @@
 #pragma once
 
 #include "Detection.h"
+#include "OverlayRenderer.h"
+#include "PointIndex.h"
 #include <opencv2/imgproc.hpp>
 #include <vector>
 #include <fstream>
+#include <mutex>
 
  /**
   * @brief The CornerDetection class is a derived class from the Detection base class.
   * It specializes in detecting and visualizing corners in an image.
   */
 class CornerDetection : public Detection {
+public:
+    static constexpr int maxCorners = 200;  // Maximum number of detected corners
+    static constexpr double defaultQualityLevel = 0.01;  // Default quality level for corner detection
+    static constexpr double defaultMinDistance = 10;  // Default minimum distance between corners
+    static constexpr int defaultBlockSize = 3;  // Default neighborhood size for corner detection
+    static constexpr bool defaultUseHarrisDetector = false;  // Use the minimum eigenvalue by default
+    static constexpr double defaultK = 0.04;  // Default free parameter for the Harris detector
+
 protected:
     // Output image with visualized corner features
 
 private:
-    cv::Mat output;
+    mutable cv::Mat output;  // Output image with visualized corners, rendered on first use
+    mutable RenderMutex renderMutex;  // Guards the lazily rendered output image
     std::vector<cv::Point2f> corners;  // Detected corner points
+    PointIndex cornerIndex;  // Spatial index over the corners in reported coordinates
     double qualityLevel;  // Quality level parameter for corner detection
     double minDistance;  // Minimum distance between corners
     int blockSize;  // Size of the neighborhood considered for corner detection
     bool useHarrisDetector;  // Flag indicating whether to use Harris corner detector
     double k;  // Free parameter for the Harris detector
 
+    /**
+     * @brief Render the output image if it is not cached yet.
+     *
+     * The caller must hold renderMutex.
+     *
+     * @return False if the working image was released in lean mode and nothing can be rendered.
+     */
+    bool renderOutput() const;
+
+protected:
+    /**
+     * @brief Release the images, keeping the detected corners.
+     */
+    void releaseIntermediates() override;
+
+    /**
+     * @brief Copy this detector with its parameters, used to run the cost model probe on.
+     */
+    std::unique_ptr<Detection> cloneDetector() const override;
+
+    /**
+     * @brief Name the cost model of this detector's configuration, including the corner parameters.
+     */
+    std::string costModelKey() const override;
+
 public:
     /**
      * @brief Constructor that initializes a CornerDetection object with the given filename.
@@ -37,6 +75,13 @@ public:
      */
     CornerDetection(const std::string& filename);
 
+    /**
+     * @brief Constructor that initializes a CornerDetection object with an already decoded image.
+     *
+     * @param image The image to be processed.
+     */
+    CornerDetection(const cv::Mat& image);
+
     /**
      * @brief Destructor for the CornerDetection class.
      */
@@ -77,6 +122,30 @@ public:
      */
     void setK(double kValue);
 
+    /**
+     * @brief Getter function to retrieve the detected corners in working-resolution coordinates.
+     *
+     * @return const std::vector<cv::Point2f>& The detected corners.
+     */
+    const std::vector<cv::Point2f>& getCorners() const;
+
+    /**
+     * @brief Getter function to retrieve the spatial index over the detected corners.
+     *
+     * Point i of the index is corner i of getanalyzeFeatures(), kept at sub-pixel precision.
+     *
+     * @return const PointIndex& The index.
+     * @throws std::logic_error if the spatial index is disabled.
+     */
+    const PointIndex& getPointIndex() const;
+
+    /**
+     * @brief Get the number of bytes held by this object.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryFootprint() const override;
+
     /**
      * @brief Overridden function to detect corner features in the image.
      */
@@ -85,7 +154,7 @@ public:
     /**
      * @brief Function to retrieve the output image with visualized corner features.
      *
-     * @return cv::Mat The output image with visualized corners.
+     * @return cv::Mat The output image with visualized corners, empty in lean mode.
      */
     cv::Mat getOutputImage() const override;
 
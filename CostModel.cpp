@@ -0,0 +1,95 @@
+/* *******************************************************
+ * Filename		:	CostModel.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	CostModel Class Implementation
+ * ******************************************************/
+
+#include "CostModel.h"
+#include <algorithm>
+#include <stdexcept>
+
+ /**
+  * @brief Constructor that creates an uncalibrated model.
+  */
+CostModel::CostModel() : fixedMs(0.0), msPerPixel(0.0), calibrated(false) {}
+
+/**
+ * @brief Fit the model with least squares.
+ *
+ * Both coefficients are clamped so the model never predicts a negative or flat cost,
+ * which would let the budget mode pick an unbounded resolution.
+ *
+ * @param samples Probe measurements as (working pixels, milliseconds).
+ */
+void CostModel::fit(const std::vector<cv::Point2d>& samples) {
+    if (samples.size() < 2) {
+        throw std::invalid_argument("Cost model needs at least two probe samples");
+    }
+
+    double meanX = 0.0, meanY = 0.0;
+    for (const cv::Point2d& sample : samples) {
+        meanX += sample.x;
+        meanY += sample.y;
+    }
+    meanX /= samples.size();
+    meanY /= samples.size();
+
+    double covariance = 0.0, variance = 0.0;
+    for (const cv::Point2d& sample : samples) {
+        covariance += (sample.x - meanX) * (sample.y - meanY);
+        variance += (sample.x - meanX) * (sample.x - meanX);
+    }
+
+    msPerPixel = variance > 0.0 ? covariance / variance : 0.0;
+    msPerPixel = std::max(msPerPixel, 1e-9);
+    fixedMs = std::max(0.0, meanY - msPerPixel * meanX);
+    calibrated = true;
+}
+
+/**
+ * @brief Refine the model with the measured time of a run.
+ *
+ * Moves the prediction a fifth of the way towards the measurement, so a single slow image
+ * does not swing the chosen resolution while a persistent drift is followed within a few runs.
+ */
+void CostModel::update(double pixels, double measuredMs) {
+    const double predicted = predict(pixels);
+    if (!calibrated || predicted <= 0.0 || measuredMs <= 0.0) {
+        return;
+    }
+
+    const double correction = 1.0 + 0.2 * (measuredMs / predicted - 1.0);
+    fixedMs *= correction;
+    msPerPixel *= correction;
+}
+
+/**
+ * @brief Predict the time for a working resolution.
+ *
+ * @return double The predicted time in milliseconds.
+ */
+double CostModel::predict(double pixels) const {
+    return fixedMs + msPerPixel * pixels;
+}
+
+/**
+ * @brief Largest number of working pixels that fits into a time budget.
+ *
+ * @return double The number of pixels.
+ */
+double CostModel::pixelsForBudget(double budgetMs) const {
+    if (!calibrated || budgetMs <= fixedMs) {
+        return 0.0;
+    }
+    return (budgetMs - fixedMs) / msPerPixel;
+}
+
+/**
+ * @brief Check whether the model has been fitted.
+ *
+ * @return bool True after fit() has been called.
+ */
+bool CostModel::isCalibrated() const {
+    return calibrated;
+}
@@ -0,0 +1,63 @@
+/* *******************************************************
+ * Filename		:	CostModel.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	CostModel Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+ /**
+  * @brief Linear latency model of a detection pipeline: time = fixed + perPixel * working pixels.
+  *
+  * The model is fitted from a short probe on synthetic images and then refined with the
+  * measured time of every budgeted run.
+  */
+class CostModel {
+private:
+    double fixedMs;         ///< Per-image cost independent of the resolution
+    double msPerPixel;      ///< Cost of one working pixel
+    bool calibrated;        ///< Whether fit() has been called
+
+public:
+    /**
+     * @brief Constructor that creates an uncalibrated model.
+     */
+    CostModel();
+
+    /**
+     * @brief Fit the model with least squares.
+     * @param samples Probe measurements as (working pixels, milliseconds).
+     * @throws std::invalid_argument if fewer than two samples are given.
+     */
+    void fit(const std::vector<cv::Point2d>& samples);
+
+    /**
+     * @brief Refine the model with the measured time of a run.
+     * @param pixels Working pixels of the run.
+     * @param measuredMs Time the run actually took.
+     */
+    void update(double pixels, double measuredMs);
+
+    /**
+     * @brief Predict the time for a working resolution.
+     * @param pixels Working pixels.
+     * @return The predicted time in milliseconds.
+     */
+    double predict(double pixels) const;
+
+    /**
+     * @brief Largest number of working pixels that fits into a time budget.
+     * @param budgetMs The time budget in milliseconds.
+     * @return The number of pixels, 0 if even the fixed cost exceeds the budget.
+     */
+    double pixelsForBudget(double budgetMs) const;
+
+    /**
+     * @brief Check whether the model has been fitted.
+     * @return True after fit() has been called.
+     */
+    bool isCalibrated() const;
+};
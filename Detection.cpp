@@ -8,6 +8,36 @@
 #include "Detection.h"
 #include "LineDetection.h"
 #include "CornerDetection.h"
+#include "Benchmark.h"
+#include "OverlayRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <typeinfo>
+
+std::map<std::string, CostModel> Detection::costModels;
+std::map<std::string, std::once_flag> Detection::calibrationFlags;
+std::mutex Detection::costModelMutex;
+
+namespace {
+    /**
+     * @brief Create a synthetic image with edges and corners for the cost model probe.
+     * @param size The image size.
+     * @return An 8-bit BGR image.
+     */
+    cv::Mat createProbeImage(const cv::Size& size) {
+        cv::Mat image(size, CV_8UC3, cv::Scalar(40, 40, 40));
+        const int step = std::max(8, size.width / 10);
+        for (int y = step / 4; y < size.height; y += step) {
+            for (int x = step / 4; x < size.width; x += step) {
+                cv::rectangle(image, cv::Rect(x, y, step / 2, step / 3), cv::Scalar((x * 7) % 256, (y * 5) % 256, 200), cv::FILLED);
+            }
+        }
+        cv::line(image, cv::Point(0, 0), cv::Point(size.width - 1, size.height - 1), cv::Scalar(255, 255, 255), 2);
+        cv::line(image, cv::Point(size.width - 1, 0), cv::Point(0, size.height - 1), cv::Scalar(255, 255, 255), 2);
+        return image;
+    }
+}
 
  /**
   * @brief Constructor for the Detection class.
@@ -16,20 +46,314 @@
   *
   * @param filename The filename of the image to be processed.
   */
-Detection::Detection(const std::string& filename) : CommonProcesses(filename) {
+Detection::Detection(const std::string& filename) : CommonProcesses(filename), latencyBudget(0.0),
+    featureScale(1.0, 1.0), analysisStart(0.0), report(), leanMode(false), preprocessed(false), spatialIndex(false) {
+}
+
+/**
+ * @brief Constructor for the Detection class that takes an already decoded image.
+ *
+ * @param image The image to be processed.
+ */
+Detection::Detection(const cv::Mat& image) : CommonProcesses(image), latencyBudget(0.0),
+    featureScale(1.0, 1.0), analysisStart(0.0), report(), leanMode(false), preprocessed(false), spatialIndex(false) {
+}
+
+/**
+ * @brief Convert to grayscale, filter noise and rescale for one pixel format.
+ *
+ * The default mode keeps the original order, blur and resize on all channels and the grayscale
+ * conversion last, so its features stay those of the golden files. Budget mode, which already
+ * rescales first, converts first: blur and resize are linear and give the same image up to rounding
+ * on the single luminance channel, at a third of the cost.
+ */
+template<PixelFormat Format>
+void Detection::preprocess(const cv::Size& target, bool scaleFirst) {
+    if (scaleFirst) {
+        convertToGraysAs<Format>();
+        rescale(target.width, target.height);
+        filterNoise();
+    }
+    else {
+        filterNoise();
+        rescale(target.width, target.height);
+        convertToGraysAs<Format>();
+    }
 }
 
 /**
  * @brief Perform common image operations.
  *
  * This method applies common image processing operations such as filtering noise, rescaling,
- * converting to grayscale, and applying bilateral filtering.
+ * converting to grayscale, and applying the selected edge-preserving denoiser.
+ *
+ * In budget mode the working resolution comes from the cost model and the image is rescaled
+ * before filtering, so the whole pipeline only pays for the chosen resolution.
  */
 void Detection::commonOperations() {
-    filterNoise();
-    rescale(800, 600);
-    convertToGrays();
-    denoiseBilateralFilter();
+    if (preprocessed) {
+        preprocessed = false;
+        analysisStart = Benchmark::nowMs();
+        return;
+    }
+
+    const bool probing = probeSize.area() > 0;
+    const bool budgeted = !probing && latencyBudget > 0.0;
+    const cv::Size target = probing ? probeSize : (budgeted ? chooseWorkingSize() : cv::Size(800, 600));
+
+    const double preprocessStart = Benchmark::nowMs();
+    report.originalSize = getOrginalPic().size();
+    report.workingSize = target;
+    report.budgetMs = budgeted ? latencyBudget : 0.0;
+    report.predictedMs = 0.0;
+    if (budgeted) {
+        std::lock_guard<std::mutex> lock(costModelMutex);
+        report.predictedMs = costModels[costModelKey()].predict(target.area());
+    }
+
+    // The only runtime dispatch on the pixel format, everything below it is specialized or format-independent.
+    switch (pixelFormatOf(getRGBPic())) {
+    case PixelFormat::Gray8:
+        preprocess<PixelFormat::Gray8>(target, probing || budgeted);
+        break;
+    default:
+        preprocess<PixelFormat::BGR8>(target, probing || budgeted);
+        break;
+    }
+    denoise();
+
+    if (budgeted) {
+        featureScale = cv::Point2d(static_cast<double>(report.originalSize.width) / target.width,
+            static_cast<double>(report.originalSize.height) / target.height);
+    }
+    else {
+        featureScale = cv::Point2d(1.0, 1.0);
+    }
+    analysisStart = Benchmark::nowMs();
+    report.preprocessMs = analysisStart - preprocessStart;
+}
+
+/**
+ * @brief Run the common operations now, so that the next analyzeFeatures() call skips them.
+ */
+void Detection::prepare() {
+    commonOperations();
+    preprocessed = true;
+}
+
+/**
+ * @brief Take over the working image prepared by another detector.
+ *
+ * The resolution, coordinate mapping and preprocessing time are copied with the image, so the
+ * features and the processing report are the same as after preprocessing this object itself. The
+ * time of this detector's own analysis is measured from the start of its analyzeFeatures() call.
+ *
+ * @param source A prepared detector.
+ * @throws std::invalid_argument if the source is not prepared.
+ */
+void Detection::adoptPreprocessing(const Detection& source) {
+    if (!source.preprocessed) {
+        throw std::invalid_argument("Preprocessing can only be adopted from a prepared detector");
+    }
+    shareWorkingImage(source.getRGBPic());
+    featureScale = source.featureScale;
+    report = source.report;
+    preprocessed = true;
+}
+
+/**
+ * @brief Run analyzeFeatures() on an executor.
+ *
+ * @param executor The executor.
+ * @return std::future<void> Ready when the analysis finishes.
+ */
+std::future<void> Detection::analyzeFeaturesAsync(TaskExecutor& executor) {
+    return executor.submit([this]() { analyzeFeatures(); });
+}
+
+/**
+ * @brief Choose the working resolution for the latency budget.
+ *
+ * The resolution keeps the aspect ratio of the original image, is never larger than the
+ * original and keeps at least 32 pixels on the shorter side.
+ *
+ * @return cv::Size The working size.
+ */
+cv::Size Detection::chooseWorkingSize() {
+    calibrateCostModel();
+
+    double pixels = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(costModelMutex);
+        pixels = costModels[costModelKey()].pixelsForBudget(latencyBudget);
+    }
+
+    const cv::Size original = getOrginalPic().size();
+    const double minScale = std::min(1.0, 32.0 / std::min(original.width, original.height));
+    const double scale = std::max(minScale, std::min(1.0, std::sqrt(pixels / original.area())));
+    return cv::Size(std::max(1, cvRound(original.width * scale)), std::max(1, cvRound(original.height * scale)));
+}
+
+/**
+ * @brief Record the elapsed time and refine the cost model with it.
+ */
+void Detection::finishProcessing() {
+    report.detectMs = Benchmark::nowMs() - analysisStart;
+    report.elapsedMs = report.preprocessMs + report.detectMs;
+    if (leanMode && probeSize.area() == 0) {
+        releaseIntermediates();
+    }
+    if (probeSize.area() > 0 || latencyBudget <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(costModelMutex);
+    costModels[costModelKey()].update(report.workingSize.area(), report.elapsedMs);
+}
+
+/**
+ * @brief Release images and temporary buffers, keeping only the detected features.
+ */
+void Detection::releaseIntermediates() {
+    releaseImages();
+}
+
+/**
+ * @brief Enable or disable the lean mode.
+ *
+ * @param lean True to enable the lean mode.
+ */
+void Detection::setLeanMode(bool lean) {
+    leanMode = lean;
+}
+
+/**
+ * @brief Check whether the lean mode is enabled.
+ *
+ * @return bool True in lean mode.
+ */
+bool Detection::isLeanMode() const {
+    return leanMode;
+}
+
+/**
+ * @brief Enable or disable the spatial index over the detected features.
+ *
+ * @param enabled True to build the index.
+ */
+void Detection::setSpatialIndex(bool enabled) {
+    spatialIndex = enabled;
+}
+
+/**
+ * @brief Check whether the spatial index is built.
+ *
+ * @return bool True if analyzeFeatures() builds the index.
+ */
+bool Detection::isSpatialIndexEnabled() const {
+    return spatialIndex;
+}
+
+/**
+ * @brief Map a point from working-resolution coordinates to reported feature coordinates.
+ *
+ * Pixel centres are mapped the same way cv::resize samples them.
+ *
+ * @param point The point in working coordinates.
+ * @return cv::Point2d The point in reported coordinates.
+ */
+cv::Point2d Detection::toFeatureCoordinates(const cv::Point2d& point) const {
+    return cv::Point2d((point.x + 0.5) * featureScale.x - 0.5, (point.y + 0.5) * featureScale.y - 0.5);
+}
+
+/**
+ * @brief Set a per-image latency budget.
+ *
+ * @param milliseconds The budget, 0 turns the budget mode off.
+ * @throws std::invalid_argument if the budget is negative.
+ */
+void Detection::setLatencyBudget(double milliseconds) {
+    if (milliseconds < 0.0) {
+        throw std::invalid_argument("Latency budget must not be negative");
+    }
+    latencyBudget = milliseconds;
+}
+
+/**
+ * @brief Get the per-image latency budget.
+ *
+ * @return double The budget in milliseconds.
+ */
+double Detection::getLatencyBudget() const {
+    return latencyBudget;
+}
+
+/**
+ * @brief Name the cost model of this detector's configuration.
+ *
+ * Models are kept apart for every configuration, so switching the denoiser or the engine, as the
+ * daemon does per request, never reads or refines the model of another configuration.
+ *
+ * @return std::string The detector type, denoiser and spatial index setting.
+ */
+std::string Detection::costModelKey() const {
+    return std::string(typeid(*this).name()) + " denoise=" + std::to_string(static_cast<int>(getDenoiseMode())) +
+        " index=" + (spatialIndex ? "1" : "0");
+}
+
+/**
+ * @brief Calibrate the cost model of this detector's configuration.
+ *
+ * Runs the full pipeline of a copy of this detector, with the current parameters, on synthetic
+ * images of three sizes after one warm-up run and fits the cost model to the measured times. The
+ * probe runs without the cost model lock, so other detectors keep reading and updating their models,
+ * and this detector's image, features and report are left untouched. The fitted model is published
+ * under the lock. A failed probe leaves the configuration uncalibrated and the next call retries it.
+ */
+void Detection::calibrateCostModel() {
+    const std::string key = costModelKey();
+    std::once_flag* flag;
+    {
+        std::lock_guard<std::mutex> lock(costModelMutex);
+        if (costModels[key].isCalibrated()) {
+            return;
+        }
+        flag = &calibrationFlags[key];
+    }
+
+    std::call_once(*flag, [this, &key]() {
+        // The copy shares the image buffers of this detector, drop them so the probe never writes into them
+        std::unique_ptr<Detection> probe = cloneDetector();
+        probe->releaseIntermediates();
+        probe->latencyBudget = 0.0;
+        probe->leanMode = false;
+        probe->preprocessed = false;
+
+        std::vector<cv::Point2d> samples;
+        const cv::Size probeSizes[] = { cv::Size(160, 120), cv::Size(160, 120), cv::Size(320, 240), cv::Size(480, 360) };
+        for (size_t i = 0; i < sizeof(probeSizes) / sizeof(probeSizes[0]); ++i) {
+            probe->setRGBPic(createProbeImage(probeSizes[i]));
+            probe->probeSize = probeSizes[i];
+            const double start = Benchmark::nowMs();
+            probe->analyzeFeatures();
+            // The first run only warms up OpenCV's allocators and thread pool.
+            if (i > 0) {
+                samples.emplace_back(probeSizes[i].area(), Benchmark::nowMs() - start);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(costModelMutex);
+        costModels[key].fit(samples);
+    });
+}
+
+/**
+ * @brief Get the resolution and timing of the last analyzeFeatures() call.
+ *
+ * @return const ProcessingReport& The processing report.
+ */
+const ProcessingReport& Detection::getProcessingReport() const {
+    return report;
 }
 
 /**
@@ -55,7 +379,7 @@ void Detection::writeFeaturesToFile(const std::string& filename) const {
         }
     }
 
-    std::cout << "Features written to file successfully: " << filename << std::endl;
+    std::cout << "Features written to file successfully: " + filename + "\n" << std::flush;
 }
 
 
@@ -67,8 +391,12 @@ void Detection::writeFeaturesToFile(const std::string& filename) const {
  * @param filename The name of the file to save the image to.
  */
 void Detection::saveOutputImage(const std::string& filename) const {
-    cv::imwrite(filename, getOutputImage());
-    std::cout << "Image saved successfully: " << filename << std::endl;
+    cv::Mat outputImage = getOutputImage();
+    if (outputImage.empty()) {
+        throw std::runtime_error("No output image to save, run analyzeFeatures() without lean mode first: " + filename);
+    }
+    cv::imwrite(filename, outputImage);
+    std::cout << "Image saved successfully: " + filename + "\n" << std::flush;
 }
 
 /**
@@ -98,20 +426,8 @@ cv::Mat Detection::combineLineAndCornerPlot() {
     lineDetection.analyzeFeatures();
     cornerDetection.analyzeFeatures();
 
-    std::vector<std::pair<int, int>> lineFeatures = lineDetection.getanalyzeFeatures();
-    std::vector<std::pair<int, int>> cornerFeatures = cornerDetection.getanalyzeFeatures();
-
-    cv::Mat combinedImage = lineDetection.getOutputImage().clone();
-
-    // Draw lines detected by LineDetection on the combined image.
-    for (const std::pair<int, int>& lineFeature : lineFeatures) {
-        cv::circle(combinedImage, cv::Point(lineFeature.first, lineFeature.second), 3, cv::Scalar(0, 255, 0), -1);
-    }
-
-    // Draw corners detected by CornerDetection on the combined image.
-    for (const std::pair<int, int>& cornerFeature : cornerFeatures) {
-        cv::circle(combinedImage, cv::Point(cornerFeature.first, cornerFeature.second), 3, cv::Scalar(255, 0, 0), -1);
-    }
+    // Draw lines, line endpoints and corners on one copy of the working image.
+    cv::Mat combinedImage = renderCombined(lineDetection, cornerDetection);
 
     // Save the combined image containing merged features to a file.
     std::string savePath = "merged_features.png";
@@ -122,3 +438,16 @@ cv::Mat Detection::combineLineAndCornerPlot() {
     cv::waitKey(0);
     return combinedImage;
 }
+
+/**
+ * @brief Render the features of two analyzed detectors into one image.
+ *
+ * All layers are drawn in a single pass on one BGR copy of the line detector's working image,
+ * using working-resolution coordinates so the markers line up in budget mode as well.
+ *
+ * @return The combined image, empty in lean mode.
+ */
+cv::Mat Detection::renderCombined(const LineDetection& lineDetection, const CornerDetection& cornerDetection) {
+    return OverlayRenderer::render(lineDetection.getRGBPic(), OverlayRenderer::Combined,
+        lineDetection.getLines(), cornerDetection.getCorners());
+}
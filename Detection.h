@@ -7,14 +7,101 @@
 
 #pragma once
 #include "CommonProcesses.h"
+#include "CostModel.h"
+#include "TaskExecutor.h"
 #include <vector>
 #include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <opencv2/highgui/highgui.hpp>
 
+class LineDetection;
+class CornerDetection;
+
+/**
+ * @brief Resolution and timing of the last analyzeFeatures() call.
+ */
+struct ProcessingReport {
+    cv::Size originalSize;  ///< Size of the input image
+    cv::Size workingSize;   ///< Resolution the pipeline ran at
+    double budgetMs;        ///< Requested latency budget, 0 when the budget mode is off
+    double predictedMs;     ///< Time predicted by the cost model, 0 when the budget mode is off
+    double preprocessMs;    ///< Time spent in preprocessing, also reported by detectors that adopted it
+    double detectMs;        ///< Time spent in this detector's own analysis after preprocessing
+    double elapsedMs;       ///< Time of preprocessing and this detector's analysis, preprocessMs + detectMs
+};
+
  /**
   * @brief Detection class that inherits from CommonProcesses and defines abstract methods for feature detection.
   */
 class Detection : public CommonProcesses {
+private:
+    double latencyBudget;       ///< Per-image time budget in milliseconds, 0 keeps the fixed 800x600 resolution
+    cv::Size probeSize;         ///< Resolution forced while the cost model probe runs
+    cv::Point2d featureScale;   ///< Scale from working to reported feature coordinates
+    double analysisStart;       ///< Start time of this detector's own analysis, after preprocessing
+    ProcessingReport report;    ///< Resolution and timing of the last analyzeFeatures() call
+    bool leanMode;              ///< Drop every intermediate once analyzeFeatures() finishes
+    bool preprocessed;          ///< The working image is ready, the next commonOperations() call is skipped
+    bool spatialIndex;          ///< Build a spatial index over the features in analyzeFeatures()
+
+    static std::map<std::string, CostModel> costModels;    ///< Calibrated cost model per detector configuration
+    static std::map<std::string, std::once_flag> calibrationFlags;  ///< Runs the cost model probe once per detector configuration
+    static std::mutex costModelMutex;                       ///< Guards costModels and calibrationFlags
+
+    /**
+     * @brief Convert to grayscale, filter noise and rescale with the pixel format fixed at compile time.
+     * @param target The working resolution.
+     * @param scaleFirst Rescale before filtering instead of after it.
+     */
+    template<PixelFormat Format>
+    void preprocess(const cv::Size& target, bool scaleFirst);
+
+    /**
+     * @brief Choose the largest working resolution that keeps the aspect ratio and fits the latency budget.
+     * @return The working size.
+     */
+    cv::Size chooseWorkingSize();
+
+protected:
+    /**
+     * @brief Record the elapsed time of the current analyzeFeatures() call and refine the cost model.
+     *
+     * Derived classes call this at the end of analyzeFeatures(). In lean mode it also releases the intermediates.
+     */
+    void finishProcessing();
+
+    /**
+     * @brief Release images and temporary buffers, keeping only the detected features.
+     *
+     * Derived classes release their own intermediates and call the base implementation.
+     */
+    virtual void releaseIntermediates();
+
+    /**
+     * @brief Copy this detector with its parameters, used to run the cost model probe on.
+     * @return The copy.
+     */
+    virtual std::unique_ptr<Detection> cloneDetector() const = 0;
+
+    /**
+     * @brief Name the cost model of this detector's configuration.
+     *
+     * Derived classes append the engine and the parameters that change their running time.
+     *
+     * @return The detector type, denoiser and spatial index setting.
+     */
+    virtual std::string costModelKey() const;
+
+    /**
+     * @brief Map a point from working-resolution coordinates to reported feature coordinates.
+     * @param point The point in working coordinates.
+     * @return The point in original-image coordinates in budget mode, unchanged otherwise.
+     */
+    cv::Point2d toFeatureCoordinates(const cv::Point2d& point) const;
+
 public:
     /**
      * @brief Constructor that initializes Detection class by invoking the base class constructor (CommonProcesses).
@@ -22,6 +109,12 @@ public:
      */
     Detection(const std::string& filename);
 
+    /**
+     * @brief Constructor that initializes Detection class with an already decoded image.
+     * @param image The image to be processed.
+     */
+    Detection(const cv::Mat& image);
+
     /**
      * @brief Virtual destructor for Detection class.
      */
@@ -56,10 +149,103 @@ public:
     std::string getFilePath();
 
     /**
-     * @brief Perform common image operations such as filtering noise, rescaling, converting to grayscale, and applying bilateral filtering.
+     * @brief Perform common image operations such as filtering noise, rescaling, converting to grayscale, and edge-preserving denoising.
      */
     void commonOperations();
 
+    /**
+     * @brief Run the common operations now, so that the next analyzeFeatures() call skips them.
+     *
+     * The elapsed time of that call still counts from the start of the preprocessing.
+     */
+    void prepare();
+
+    /**
+     * @brief Take over the working image prepared by another detector instead of preprocessing again.
+     *
+     * The source must have been prepared from the same image with the same denoiser, and this has to be
+     * called before the source's analyzeFeatures(). The pixel data is shared, not copied.
+     *
+     * @param source A detector on which prepare() was called.
+     * @throws std::invalid_argument if the source is not prepared.
+     */
+    void adoptPreprocessing(const Detection& source);
+
+    /**
+     * @brief Run analyzeFeatures() on an executor.
+     *
+     * The object must not be used until the future is ready.
+     *
+     * @param executor The executor, the process-wide one by default.
+     * @return A future that becomes ready when the analysis finishes and rethrows its exceptions.
+     */
+    std::future<void> analyzeFeaturesAsync(TaskExecutor& executor = TaskExecutor::shared());
+
+    /**
+     * @brief Set a per-image latency budget.
+     *
+     * With a positive budget the working resolution is chosen by the cost model instead of the fixed 800x600,
+     * the aspect ratio is kept and features are reported in original-image coordinates.
+     *
+     * @param milliseconds The budget, 0 turns the budget mode off.
+     */
+    void setLatencyBudget(double milliseconds);
+
+    /**
+     * @brief Get the per-image latency budget.
+     * @return The budget in milliseconds, 0 when the budget mode is off.
+     */
+    double getLatencyBudget() const;
+
+    /**
+     * @brief Calibrate the cost model of this detector type with a quick probe on synthetic images.
+     *
+     * Runs once per detector configuration, see costModelKey(), on a copy of this detector, later calls
+     * return immediately. Concurrent callers of the same configuration wait for the running probe,
+     * other configurations and threads are not blocked.
+     * Budgeted runs calibrate on first use, calling this at startup keeps the probe out of the first
+     * image's latency.
+     */
+    void calibrateCostModel();
+
+    /**
+     * @brief Enable or disable the lean mode.
+     *
+     * In lean mode every image and temporary buffer is released once analyzeFeatures() finishes and only
+     * the features are kept, so output images and plots are no longer available.
+     *
+     * @param lean True to enable the lean mode.
+     */
+    void setLeanMode(bool lean);
+
+    /**
+     * @brief Check whether the lean mode is enabled.
+     * @return True in lean mode.
+     */
+    bool isLeanMode() const;
+
+    /**
+     * @brief Enable or disable the spatial index over the detected features.
+     *
+     * When enabled, analyzeFeatures() also indexes the features in reported coordinates for fast range,
+     * nearest-neighbour and intersection queries. The index is kept in lean mode.
+     *
+     * @param enabled True to build the index.
+     */
+    void setSpatialIndex(bool enabled);
+
+    /**
+     * @brief Check whether the spatial index is built.
+     * @return True if analyzeFeatures() builds the index.
+     */
+    bool isSpatialIndexEnabled() const;
+
+    /**
+     * @brief Get the resolution and timing of the last analyzeFeatures() call.
+     * @return The processing report.
+     */
+    const ProcessingReport& getProcessingReport() const;
+
     /**
      * @brief Write the detected features (lines or corners) to a specified file.
      * @param filename The name of the file to write features to.
@@ -77,4 +263,12 @@ public:
      * @return The merged image containing both lines and corners.
      */
     cv::Mat combineLineAndCornerPlot();
+
+    /**
+     * @brief Render the lines, line endpoints and corners of two analyzed detectors into one image in a single pass.
+     * @param lineDetection Analyzed line detector, its working image is used as the base.
+     * @param cornerDetection Analyzed corner detector running at the same working resolution.
+     * @return The combined image, empty if the line detector ran in lean mode.
+     */
+    static cv::Mat renderCombined(const LineDetection& lineDetection, const CornerDetection& cornerDetection);
 };
@@ -0,0 +1,129 @@
+/* *******************************************************
+ * Filename		:	DetectionClient.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	DetectionClient Class Implementation
+ * ******************************************************/
+
+#include "DetectionClient.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+ /**
+  * @brief Constructor that connects to the daemon.
+  *
+  * @param socketPath The daemon's socket path.
+  */
+DetectionClient::DetectionClient(const std::string& socketPath) : connection(LocalSocket::connect(socketPath)) {}
+
+/**
+ * @brief Send a request for an image path and collect the response.
+ *
+ * @return bool True if the daemon answered OK.
+ */
+bool DetectionClient::detectPath(const std::string& detector, const std::string& imagePath, const std::string& parameters, std::vector<std::string>& response) {
+    // The path runs to the end of the header, so the parameters go first.
+    std::string header = "DETECT " + detector + (parameters.empty() ? "" : " " + parameters) + " PATH " + imagePath;
+    if (!connection.writeAll(header + "\n")) {
+        throw std::runtime_error("Connection to the detection daemon was closed");
+    }
+    return readResponse(response);
+}
+
+/**
+ * @brief Send a request with the encoded image bytes and collect the response.
+ *
+ * @return bool True if the daemon answered OK.
+ */
+bool DetectionClient::detectBytes(const std::string& detector, const std::vector<unsigned char>& imageBytes, const std::string& parameters, std::vector<std::string>& response) {
+    std::string header = "DETECT " + detector + " BYTES " + std::to_string(imageBytes.size());
+    if (!parameters.empty()) {
+        header += " " + parameters;
+    }
+    if (!connection.writeAll(header + "\n") ||
+        !connection.writeAll(reinterpret_cast<const char*>(imageBytes.data()), imageBytes.size())) {
+        throw std::runtime_error("Connection to the detection daemon was closed");
+    }
+    return readResponse(response);
+}
+
+/**
+ * @brief Read response lines up to END.
+ *
+ * @return bool True if the first line is OK.
+ */
+bool DetectionClient::readResponse(std::vector<std::string>& response) {
+    response.clear();
+    std::string line;
+    while (connection.readLine(line)) {
+        if (line == "END") {
+            return !response.empty() && response.front().compare(0, 2, "OK") == 0;
+        }
+        response.push_back(line);
+    }
+    throw std::runtime_error("Connection to the detection daemon was closed");
+}
+
+/**
+ * @brief Run concurrent clients against the daemon and report latency percentiles.
+ *
+ * Every client opens its own connection and sends its requests back to back. The daemon queues
+ * requests rather than connections, so once the concurrency exceeds its worker count the measured
+ * latency includes the wait of each request for the next free worker.
+ */
+void DetectionClient::runLoadTest(const std::string& socketPath, const std::string& imagePath, const std::string& detector,
+    int concurrency, int requestsPerClient, std::ostream& os) {
+    std::vector<double> latencies;
+    std::mutex latencyMutex;
+    std::atomic<int> failures(0);
+
+    const double start = Benchmark::nowMs();
+    std::vector<std::thread> clients;
+    for (int c = 0; c < concurrency; ++c) {
+        clients.emplace_back([&]() {
+            std::vector<double> local;
+            try {
+                DetectionClient client(socketPath);
+                std::vector<std::string> response;
+                for (int r = 0; r < requestsPerClient; ++r) {
+                    const double sent = Benchmark::nowMs();
+                    if (!client.detectPath(detector, imagePath, "", response)) {
+                        ++failures;
+                    }
+                    local.push_back(Benchmark::nowMs() - sent);
+                }
+            }
+            catch (const std::exception&) {
+                ++failures;
+            }
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latencies.insert(latencies.end(), local.begin(), local.end());
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    const double wallMs = Benchmark::nowMs() - start;
+
+    if (latencies.empty()) {
+        os << "No request completed, failures: " << failures << std::endl;
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t index = static_cast<size_t>(p * (latencies.size() - 1) + 0.5);
+        return latencies[std::min(index, latencies.size() - 1)];
+    };
+
+    os << std::fixed << std::setprecision(2)
+        << "Requests: " << latencies.size() << ", concurrency: " << concurrency << ", failures: " << failures << "\n"
+        << "Latency p50: " << percentile(0.50) << " ms, p99: " << percentile(0.99) << " ms, max: " << latencies.back() << " ms\n"
+        << "Throughput: " << latencies.size() * 1000.0 / wallMs << " requests/s" << std::endl;
+}
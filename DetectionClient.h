@@ -0,0 +1,68 @@
+/* *******************************************************
+ * Filename		:	DetectionClient.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	DetectionClient Class Header
+ * ******************************************************/
+
+#pragma once
+#include "LocalSocket.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief Client of the detection daemon, also provides the load-test tool.
+  */
+class DetectionClient {
+private:
+    LocalSocket connection;     ///< Connection to the daemon, reused for all requests
+
+    /**
+     * @brief Read response lines up to END.
+     * @param response Receives the response lines.
+     * @return True if the first line is OK.
+     */
+    bool readResponse(std::vector<std::string>& response);
+
+public:
+    /**
+     * @brief Constructor that connects to the daemon.
+     * @param socketPath The daemon's socket path.
+     */
+    DetectionClient(const std::string& socketPath);
+
+    /**
+     * @brief Send a request for an image path and collect the response.
+     * @param detector lines, corners or both.
+     * @param imagePath Path of the image as seen by the daemon.
+     * @param parameters key=value parameters separated by spaces, may be empty.
+     * @param response Receives the response lines, without the terminating END.
+     * @return True if the daemon answered OK.
+     * @throws std::runtime_error if the connection breaks.
+     */
+    bool detectPath(const std::string& detector, const std::string& imagePath, const std::string& parameters, std::vector<std::string>& response);
+
+    /**
+     * @brief Send a request with the encoded image bytes and collect the response.
+     * @param detector lines, corners or both.
+     * @param imageBytes The encoded image, e.g. the content of a PNG file.
+     * @param parameters key=value parameters separated by spaces, may be empty.
+     * @param response Receives the response lines, without the terminating END.
+     * @return True if the daemon answered OK.
+     * @throws std::runtime_error if the connection breaks.
+     */
+    bool detectBytes(const std::string& detector, const std::vector<unsigned char>& imageBytes, const std::string& parameters, std::vector<std::string>& response);
+
+    /**
+     * @brief Run concurrent clients against the daemon and report latency percentiles.
+     * @param socketPath The daemon's socket path.
+     * @param imagePath Image requested by every client.
+     * @param detector lines, corners or both.
+     * @param concurrency Number of concurrent client connections.
+     * @param requestsPerClient Number of sequential requests per client.
+     * @param os The stream the report is written to.
+     */
+    static void runLoadTest(const std::string& socketPath, const std::string& imagePath, const std::string& detector,
+        int concurrency, int requestsPerClient, std::ostream& os);
+};
@@ -0,0 +1,420 @@
+/* *******************************************************
+ * Filename		:	DetectionServer.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	DetectionServer Class Implementation
+ * ******************************************************/
+
+#include "DetectionServer.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+ /**
+  * @brief Constructor that binds the socket and starts the worker pool.
+  *
+  * @param socketPath The socket path.
+  * @param workerCount Number of worker threads, 0 uses the number of hardware threads.
+  * @param maxPayloadBytes Largest accepted encoded image.
+  */
+DetectionServer::DetectionServer(const std::string& socketPath, int workerCount, size_t maxPayloadBytes)
+    : socketPath(socketPath), workerCount(workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency())),
+    maxPayloadBytes(maxPayloadBytes) {
+    listener = LocalSocket::listen(socketPath, 64);
+    // A connection to the daemon's own socket serves as the wake-up channel of the accepting thread
+    wakeWriter = LocalSocket::connect(socketPath);
+    wakeReader = listener.accept();
+    if (!wakeReader.isOpen()) {
+        throw std::runtime_error("Could not set up the daemon's wake-up connection: " + socketPath);
+    }
+    for (int i = 0; i < this->workerCount; ++i) {
+        workers.emplace_back(&DetectionServer::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Destructor, removes the socket file.
+ *
+ * The workers block on connections for the lifetime of the process and are detached here.
+ */
+DetectionServer::~DetectionServer() {
+    for (std::thread& worker : workers) {
+        worker.detach();
+    }
+    listener.close();
+    std::remove(socketPath.c_str());
+}
+
+/**
+ * @brief Accept connections and queue their requests to the worker pool.
+ *
+ * Idle connections are watched here together with the listener. A connection that becomes
+ * readable, with a request or because the client hung up, is queued to the workers and watched
+ * again once a worker returns it. Failing waits and accept calls, for example when the process
+ * runs out of file descriptors, are retried with an exponential back-off of up to one second
+ * instead of spinning.
+ */
+void DetectionServer::run() {
+    std::cout << "Detection daemon listening on " << socketPath << " with " << workerCount << " workers" << std::endl;
+    std::vector<LocalSocket> idle;
+    std::vector<const LocalSocket*> watched;
+    std::vector<char> readable;
+    int backoffMs = 0;
+    auto backOff = [&backoffMs](const char* what) {
+        if (backoffMs == 0) {
+            std::cerr << what << " failed, retrying" << std::endl;
+        }
+        backoffMs = std::min(1000, std::max(10, backoffMs * 2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoffMs));
+    };
+
+    while (listener.isOpen()) {
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            for (LocalSocket& connection : returned) {
+                idle.push_back(std::move(connection));
+            }
+            returned.clear();
+        }
+
+        watched.assign({ &listener, &wakeReader });
+        for (const LocalSocket& connection : idle) {
+            watched.push_back(&connection);
+        }
+        if (!LocalSocket::waitReadable(watched, readable)) {
+            backOff("Waiting for requests");
+            continue;
+        }
+        if (readable[1] && !wakeReader.discard()) {
+            throw std::runtime_error("The daemon's wake-up connection was closed");
+        }
+
+        // Walking backwards, the last connection moved into a freed slot has already been checked
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex);
+            for (size_t i = idle.size(); i-- > 0;) {
+                if (readable[i + 2]) {
+                    pending.push_back(std::move(idle[i]));
+                    idle[i] = std::move(idle.back());
+                    idle.pop_back();
+                    queued = true;
+                }
+            }
+        }
+        if (queued) {
+            connectionReady.notify_all();
+        }
+
+        if (readable[0]) {
+            LocalSocket connection = listener.accept();
+            if (!connection.isOpen()) {
+                backOff("Accepting a connection");
+                continue;
+            }
+            connection.setReadTimeout(requestTimeoutMs);
+            idle.push_back(std::move(connection));
+        }
+        backoffMs = 0;
+    }
+}
+
+/**
+ * @brief Worker thread body.
+ *
+ * A warm-up detection on a synthetic image initializes OpenCV, its thread pool and the allocators
+ * before the first request arrives. The payload and response buffers live as long as the worker.
+ * After every request the connection goes back to the accepting thread, or straight back to the
+ * queue if the client has already sent more.
+ */
+void DetectionServer::workerLoop() {
+    std::vector<unsigned char> payload;
+    std::string response;
+    payload.reserve(4 << 20);
+    response.reserve(256 << 10);
+
+    try {
+        cv::Mat warmUp(600, 800, CV_8UC3, cv::Scalar(40, 40, 40));
+        cv::rectangle(warmUp, cv::Rect(200, 150, 400, 300), cv::Scalar(220, 220, 220), cv::FILLED);
+        LineDetection lines(warmUp);
+        lines.analyzeFeatures();
+        CornerDetection corners(warmUp);
+        corners.analyzeFeatures();
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Warm-up failed: " << ex.what() << std::endl;
+    }
+
+    while (true) {
+        LocalSocket connection;
+        {
+            std::unique_lock<std::mutex> lock(connectionMutex);
+            connectionReady.wait(lock, [this]() { return !pending.empty(); });
+            connection = std::move(pending.front());
+            pending.pop_front();
+        }
+        if (!serveRequest(connection, payload, response)) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        if (connection.hasBufferedData()) {
+            // Pipelined requests are already buffered and would never wake the accepting thread
+            pending.push_back(std::move(connection));
+            connectionReady.notify_one();
+        }
+        else {
+            returned.push_back(std::move(connection));
+            wakeWriter.writeAll("\n");
+        }
+    }
+}
+
+/**
+ * @brief Serve the next request of a connection.
+ *
+ * Nothing may escape a worker thread, so any exception ends only this connection.
+ *
+ * @return bool False if the client hung up, the request could not be read or the connection broke.
+ */
+bool DetectionServer::serveRequest(LocalSocket& connection, std::vector<unsigned char>& payload, std::string& response) {
+    try {
+        std::string header;
+        if (!connection.readLine(header)) {
+            return false;
+        }
+        std::vector<std::string> tokens;
+        std::istringstream stream(header);
+        for (std::string token; stream >> token;) {
+            tokens.push_back(token);
+        }
+
+        if (tokens.size() == 1 && tokens[0] == "PING") {
+            return connection.writeAll("PONG\nEND\n");
+        }
+        if (tokens.size() >= 4 && tokens[0] == "DETECT") {
+            return handleDetect(header, connection, payload, response);
+        }
+        return connection.writeAll("ERR malformed request\nEND\n");
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Connection closed after an error: " << ex.what() << std::endl;
+    }
+    catch (...) {
+        std::cerr << "Connection closed after an unknown error" << std::endl;
+    }
+    return false;
+}
+
+/**
+ * @brief Run one detection request and stream the features back.
+ *
+ * Features are appended to the response buffer and flushed whenever it passes 64 KiB, so large
+ * results start arriving before the whole response is formatted.
+ */
+bool DetectionServer::handleDetect(const std::string& header, LocalSocket& connection, std::vector<unsigned char>& payload, std::string& response) {
+    // Split at blanks, keeping the offset of every token so that a path can run to the end of the line
+    std::vector<std::string> tokens;
+    std::vector<size_t> offsets;
+    for (size_t begin = header.find_first_not_of(" \t"); begin != std::string::npos; begin = header.find_first_not_of(" \t", begin)) {
+        const size_t end = std::min(header.find_first_of(" \t", begin), header.size());
+        offsets.push_back(begin);
+        tokens.push_back(header.substr(begin, end - begin));
+        begin = end;
+    }
+
+    const std::string& detector = tokens[1];
+    size_t sourceIndex = 2;
+    while (sourceIndex < tokens.size() && tokens[sourceIndex] != "PATH" && tokens[sourceIndex] != "BYTES") {
+        ++sourceIndex;
+    }
+    const std::string source = sourceIndex < tokens.size() ? tokens[sourceIndex] : "";
+    std::vector<std::string> parameters(tokens.begin() + 2, tokens.begin() + sourceIndex);
+    std::string imagePath;
+
+    // The payload must be consumed even if the request turns out to be invalid, a length that cannot
+    // be honoured leaves the stream out of sync and closes the connection.
+    if (source == "BYTES") {
+        const std::string lengthToken = sourceIndex + 1 < tokens.size() ? tokens[sourceIndex + 1] : "";
+        unsigned long long length = 0;
+        try {
+            if (lengthToken.empty() || lengthToken.find_first_not_of("0123456789") != std::string::npos) {
+                throw std::invalid_argument(lengthToken);
+            }
+            length = std::stoull(lengthToken);
+        }
+        catch (const std::exception&) {
+            connection.writeAll("ERR invalid payload length\nEND\n");
+            return false;
+        }
+        if (length > maxPayloadBytes) {
+            connection.writeAll("ERR payload exceeds " + std::to_string(maxPayloadBytes) + " bytes\nEND\n");
+            return false;
+        }
+        if (!connection.readExact(payload, static_cast<size_t>(length))) {
+            return false;
+        }
+        parameters.insert(parameters.end(), tokens.begin() + sourceIndex + 2, tokens.end());
+    }
+    else if (source == "PATH" && sourceIndex + 1 < tokens.size()) {
+        imagePath = header.substr(offsets[sourceIndex + 1]);
+        imagePath.erase(imagePath.find_last_not_of(" \t") + 1);
+    }
+
+    std::vector<std::pair<int, int>> lineFeatures;
+    std::vector<std::pair<int, int>> cornerFeatures;
+    const double start = Benchmark::nowMs();
+
+    try {
+        if (detector != "lines" && detector != "corners" && detector != "both") {
+            throw std::invalid_argument("unknown detector " + detector);
+        }
+
+        cv::Mat image;
+        if (source == "PATH") {
+            if (imagePath.empty()) {
+                throw std::invalid_argument("missing image path");
+            }
+            image = cv::imread(imagePath, CommonProcesses::imageReadFlags);
+        }
+        else if (source == "BYTES") {
+            image = cv::imdecode(payload, CommonProcesses::imageReadFlags);
+        }
+        else {
+            throw std::invalid_argument("missing image source");
+        }
+        if (image.empty()) {
+            throw std::runtime_error("could not decode the image");
+        }
+
+        std::unique_ptr<LineDetection> lines;
+        std::unique_ptr<CornerDetection> corners;
+        if (detector != "corners") {
+            lines.reset(new LineDetection(image));
+        }
+        if (detector != "lines") {
+            corners.reset(new CornerDetection(image));
+        }
+        applyParameters(parameters, lines.get(), corners.get());
+
+        if (lines) {
+            lines->analyzeFeatures();
+            lineFeatures = lines->getanalyzeFeatures();
+        }
+        if (corners) {
+            corners->analyzeFeatures();
+            cornerFeatures = corners->getanalyzeFeatures();
+        }
+    }
+    catch (const std::exception& ex) {
+        return connection.writeAll("ERR " + std::string(ex.what()) + "\nEND\n");
+    }
+
+    response.clear();
+    response += "OK lines=" + std::to_string(lineFeatures.size() / 2) + " corners=" + std::to_string(cornerFeatures.size()) +
+        " ms=" + std::to_string(Benchmark::nowMs() - start) + "\n";
+
+    for (size_t i = 0; i + 1 < lineFeatures.size(); i += 2) {
+        response += "L " + std::to_string(lineFeatures[i].first) + " " + std::to_string(lineFeatures[i].second) + " " +
+            std::to_string(lineFeatures[i + 1].first) + " " + std::to_string(lineFeatures[i + 1].second) + "\n";
+        if (response.size() > (64 << 10)) {
+            if (!connection.writeAll(response)) {
+                return false;
+            }
+            response.clear();
+        }
+    }
+    for (const std::pair<int, int>& corner : cornerFeatures) {
+        response += "C " + std::to_string(corner.first) + " " + std::to_string(corner.second) + "\n";
+        if (response.size() > (64 << 10)) {
+            if (!connection.writeAll(response)) {
+                return false;
+            }
+            response.clear();
+        }
+    }
+    response += "END\n";
+    return connection.writeAll(response);
+}
+
+/**
+ * @brief Apply key=value request parameters to the detectors.
+ *
+ * Parameters that only concern one detector are ignored when that detector is not requested.
+ */
+void DetectionServer::applyParameters(const std::vector<std::string>& parameters, LineDetection* lines, CornerDetection* corners) {
+    for (const std::string& parameter : parameters) {
+        const size_t separator = parameter.find('=');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("parameter without value " + parameter);
+        }
+        const std::string key = parameter.substr(0, separator);
+        const std::string value = parameter.substr(separator + 1);
+
+        if (key == "engine") {
+            LineEngine engine = value == "compact" ? LineEngine::CompactHough :
+                value == "lsd" ? LineEngine::SegmentDetector : LineEngine::OpenCVHough;
+            if (value != "compact" && value != "lsd" && value != "opencv") {
+                throw std::invalid_argument("unknown engine " + value);
+            }
+            if (lines) {
+                lines->setLineEngine(engine);
+            }
+        }
+        else if (key == "denoise") {
+            if (value != "bilateral" && value != "fast") {
+                throw std::invalid_argument("unknown denoiser " + value);
+            }
+            DenoiseMode mode = value == "fast" ? DenoiseMode::FastGuided : DenoiseMode::Bilateral;
+            if (lines) {
+                lines->setDenoiseMode(mode);
+            }
+            if (corners) {
+                corners->setDenoiseMode(mode);
+            }
+        }
+        else if (key == "budget") {
+            if (lines) {
+                lines->setLatencyBudget(std::stod(value));
+            }
+            if (corners) {
+                corners->setLatencyBudget(std::stod(value));
+            }
+        }
+        else if (key == "threshold") {
+            if (lines) {
+                lines->setThreshold(std::stoi(value));
+            }
+        }
+        else if (key == "quality" || key == "mindistance" || key == "blocksize" || key == "harris" || key == "k") {
+            if (!corners) {
+                continue;
+            }
+            if (key == "quality") {
+                corners->setQualityLevel(std::stod(value));
+            }
+            else if (key == "mindistance") {
+                corners->setMinDistance(std::stod(value));
+            }
+            else if (key == "blocksize") {
+                corners->setBlockSize(std::stoi(value));
+            }
+            else if (key == "harris") {
+                corners->setUseHarrisDetector(value == "1" || value == "true");
+            }
+            else {
+                corners->setK(std::stod(value));
+            }
+        }
+        else {
+            throw std::invalid_argument("unknown parameter " + key);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+/* *******************************************************
+ * Filename		:	DetectionServer.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	DetectionServer Class Header
+ * ******************************************************/
+
+#pragma once
+#include "LocalSocket.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LineDetection;
+class CornerDetection;
+
+ /**
+  * @brief Resident detection daemon serving requests over a Unix domain socket.
+  *
+  * Requests are one header line, optionally followed by the encoded image bytes:
+  *
+  *     DETECT <lines|corners|both> [key=value ...] PATH <image path>
+  *     DETECT <lines|corners|both> BYTES <length> [key=value ...]
+  *     PING
+  *
+  * The image path runs to the end of the line, so it may contain spaces. Headers longer than 64 KiB
+  * and payloads larger than the configured maximum close the connection.
+  *
+  * Supported parameters: threshold, engine (opencv, compact, lsd), denoise (bilateral, fast), budget,
+  * quality, mindistance, blocksize, harris, k. The response starts with "OK lines=<n> corners=<m> ms=<t>"
+  * or "ERR <message>", streams one "L x1 y1 x2 y2" or "C x y" line per feature and ends with "END".
+  * A connection can carry any number of requests.
+  *
+  * Requests, not connections, are queued to a fixed pool of worker threads that are warmed up at
+  * startup and keep their payload and response buffers between requests. The accepting thread
+  * watches every idle connection and queues it only once a request arrives, the worker hands it back
+  * after the response. Idle keep-alive clients therefore hold no worker. A request whose header or
+  * payload stalls for longer than requestTimeoutMs closes its connection.
+  */
+class DetectionServer {
+private:
+    std::string socketPath;                 ///< Path the daemon listens on
+    int workerCount;                        ///< Number of worker threads
+    size_t maxPayloadBytes;                 ///< Largest accepted BYTES payload
+    static const int requestTimeoutMs = 10000;  ///< Longest wait for the rest of a started request
+
+    LocalSocket listener;                   ///< Listening socket
+    LocalSocket wakeReader;                 ///< Watched by the accepting thread, woken when a connection is returned
+    LocalSocket wakeWriter;                 ///< Written by the workers to wake the accepting thread
+    std::deque<LocalSocket> pending;        ///< Connections with a request waiting for a worker
+    std::vector<LocalSocket> returned;      ///< Connections answered by a worker, to be watched again
+    std::mutex connectionMutex;             ///< Guards pending, returned and wakeWriter
+    std::condition_variable connectionReady;    ///< Signals a pending request
+    std::vector<std::thread> workers;       ///< Warm worker pool
+
+    /**
+     * @brief Worker thread body: warm up, then serve requests until the process exits.
+     */
+    void workerLoop();
+
+    /**
+     * @brief Serve the next request of a connection.
+     *
+     * Never throws, a failing connection is logged and reported as closed.
+     *
+     * @param connection The client connection.
+     * @param payload Reused buffer for image bytes.
+     * @param response Reused buffer for the response text.
+     * @return False if the connection must be closed.
+     */
+    bool serveRequest(LocalSocket& connection, std::vector<unsigned char>& payload, std::string& response);
+
+    /**
+     * @brief Run one detection request and stream the features back.
+     * @param header The request header line.
+     * @param connection The client connection.
+     * @param payload Reused buffer for image bytes.
+     * @param response Reused buffer for the response text.
+     * @return False if the connection broke.
+     */
+    bool handleDetect(const std::string& header, LocalSocket& connection, std::vector<unsigned char>& payload, std::string& response);
+
+    /**
+     * @brief Apply key=value request parameters to the detectors.
+     * @param parameters The key=value tokens of the request.
+     * @param lines Line detector, may be null.
+     * @param corners Corner detector, may be null.
+     * @throws std::invalid_argument for unknown parameters or values.
+     */
+    static void applyParameters(const std::vector<std::string>& parameters, LineDetection* lines, CornerDetection* corners);
+
+public:
+    /**
+     * @brief Constructor that binds the socket and starts the worker pool.
+     * @param socketPath The socket path.
+     * @param workerCount Number of worker threads, 0 uses the number of hardware threads.
+     * @param maxPayloadBytes Largest accepted encoded image.
+     */
+    DetectionServer(const std::string& socketPath, int workerCount, size_t maxPayloadBytes = 64 << 20);
+
+    /**
+     * @brief Destructor, removes the socket file.
+     */
+    ~DetectionServer();
+
+    /**
+     * @brief Accept connections and queue their requests to the worker pool until the listener fails for good.
+     */
+    void run();
+};
@@ -0,0 +1,186 @@
+/* *******************************************************
+ * Filename		:	FeatureFusion.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	FeatureFusion Class Implementation
+ * ******************************************************/
+
+#include "FeatureFusion.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+#include "SegmentIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    /**
+     * @brief Direction of the vector from one point to another in degrees in [0, 360).
+     */
+    double directionOf(const cv::Point2f& from, const cv::Point2f& to) {
+        double degrees = std::atan2(to.y - from.y, to.x - from.x) * 180.0 / CV_PI;
+        return degrees < 0.0 ? degrees + 360.0 : degrees;
+    }
+
+    /**
+     * @brief Collect the rays of the segments near one corner into a junction.
+     * @param segments The segments.
+     * @param corner The corner position.
+     * @param radius Maximum corner to segment distance.
+     * @param candidates Ids of the segments to be checked exactly.
+     * @param junction Filled with the rays, sorted by direction.
+     */
+    void collectRays(const std::vector<cv::Vec4f>& segments, const cv::Point2f& corner, float radius,
+        const std::vector<int>& candidates, Junction& junction) {
+        const float radiusSquared = radius * radius;
+        std::vector<std::pair<double, int>> rays;
+        for (int id : candidates) {
+            const cv::Vec4f& segment = segments[id];
+            if (SegmentIndex::distanceSquared(corner, segment) > radiusSquared) {
+                continue;
+            }
+            const cv::Point2f a(segment[0], segment[1]);
+            const cv::Point2f b(segment[2], segment[3]);
+            const float da = (a.x - corner.x) * (a.x - corner.x) + (a.y - corner.y) * (a.y - corner.y);
+            const float db = (b.x - corner.x) * (b.x - corner.x) + (b.y - corner.y) * (b.y - corner.y);
+            if (da > radiusSquared && db > radiusSquared) {
+                // The segment passes through the corner, both halves leave it.
+                rays.emplace_back(directionOf(corner, a), id);
+                rays.emplace_back(directionOf(corner, b), id);
+            }
+            else {
+                // The segment ends at the corner and leaves it towards its far endpoint.
+                rays.emplace_back(da <= db ? directionOf(a, b) : directionOf(b, a), id);
+            }
+        }
+
+        std::sort(rays.begin(), rays.end());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            junction.directions.push_back(rays[i].first);
+            junction.segments.push_back(rays[i].second);
+            const double next = i + 1 < rays.size() ? rays[i + 1].first : rays[0].first + 360.0;
+            junction.angles.push_back(next - rays[i].first);
+        }
+    }
+
+    /**
+     * @brief Extract the junctions with a ready index over the segments.
+     *
+     * Without an index every segment is a candidate of every corner.
+     */
+    std::vector<Junction> extractWithIndex(const SegmentIndex* index, const std::vector<cv::Vec4f>& segments,
+        const std::vector<cv::Point2f>& corners, float radius, int minRays) {
+        if (radius <= 0.0f) {
+            throw std::invalid_argument("Junction radius must be positive");
+        }
+
+        std::vector<Junction> junctions;
+        std::vector<int> candidates;
+        if (!index) {
+            for (size_t i = 0; i < segments.size(); ++i) {
+                candidates.push_back(static_cast<int>(i));
+            }
+        }
+        for (size_t i = 0; i < corners.size(); ++i) {
+            const cv::Point2f& corner = corners[i];
+            if (index) {
+                index->queryBox(cv::Rect2f(corner.x - radius, corner.y - radius, 2.0f * radius, 2.0f * radius), candidates);
+            }
+            Junction junction;
+            junction.corner = static_cast<int>(i);
+            collectRays(segments, corner, radius, candidates, junction);
+            if (static_cast<int>(junction.segments.size()) >= std::max(1, minRays)) {
+                junctions.push_back(std::move(junction));
+            }
+        }
+        return junctions;
+    }
+}
+
+ /**
+  * @brief Extract the junctions from plain feature vectors.
+  *
+  * @return std::vector<Junction> The junctions in corner order.
+  * @throws std::invalid_argument if the radius is not positive.
+  */
+std::vector<Junction> FeatureFusion::extractJunctions(const std::vector<cv::Vec4f>& segments, const std::vector<cv::Point2f>& corners,
+    float radius, int minRays) {
+    SegmentIndex index;
+    index.build(segments);
+    return extractWithIndex(&index, segments, corners, radius, minRays);
+}
+
+/**
+ * @brief Extract the junctions by testing every segment against every corner.
+ *
+ * Runs the same exact distance check and ray construction as extractJunctions() without the index
+ * query, in O(lines x corners).
+ *
+ * @return std::vector<Junction> The junctions in corner order.
+ * @throws std::invalid_argument if the radius is not positive.
+ */
+std::vector<Junction> FeatureFusion::extractJunctionsBruteForce(const std::vector<cv::Vec4f>& segments, const std::vector<cv::Point2f>& corners,
+    float radius, int minRays) {
+    return extractWithIndex(nullptr, segments, corners, radius, minRays);
+}
+
+/**
+ * @brief Extract the junctions of two analyzed detectors in reported feature coordinates.
+ *
+ * @return std::vector<Junction> The junctions in corner order.
+ */
+std::vector<Junction> FeatureFusion::extractJunctions(const LineDetection& lineDetection, const CornerDetection& cornerDetection,
+    float radius, int minRays) {
+    const std::vector<std::pair<int, int>> endpoints = lineDetection.getanalyzeFeatures();
+    std::vector<cv::Vec4f> segments;
+    segments.reserve(endpoints.size() / 2);
+    for (size_t i = 0; i + 1 < endpoints.size(); i += 2) {
+        segments.push_back(cv::Vec4f(static_cast<float>(endpoints[i].first), static_cast<float>(endpoints[i].second),
+            static_cast<float>(endpoints[i + 1].first), static_cast<float>(endpoints[i + 1].second)));
+    }
+
+    std::vector<cv::Point2f> corners;
+    for (const std::pair<int, int>& corner : cornerDetection.getanalyzeFeatures()) {
+        corners.push_back(cv::Point2f(static_cast<float>(corner.first), static_cast<float>(corner.second)));
+    }
+
+    if (lineDetection.isSpatialIndexEnabled()) {
+        return extractWithIndex(&lineDetection.getSegmentIndex(), segments, corners, radius, minRays);
+    }
+    return extractJunctions(segments, corners, radius, minRays);
+}
+
+/**
+ * @brief Write junctions with one record per line.
+ *
+ * Example: "12;3 7 7;90.0 90.0 180.0" is corner 12 with a segment 3 ending at it and segment 7
+ * passing through it.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void FeatureFusion::writeJunctionsToFile(const std::vector<Junction>& junctions, const std::string& filename) {
+    std::ofstream outFile(filename);
+    if (!outFile.is_open()) {
+        throw std::runtime_error("Could not open the file for writing: " + filename);
+    }
+
+    outFile << std::fixed << std::setprecision(1);
+    for (const Junction& junction : junctions) {
+        outFile << junction.corner << ";";
+        for (size_t i = 0; i < junction.segments.size(); ++i) {
+            outFile << (i ? " " : "") << junction.segments[i];
+        }
+        outFile << ";";
+        for (size_t i = 0; i < junction.angles.size(); ++i) {
+            outFile << (i ? " " : "") << junction.angles[i];
+        }
+        outFile << "\n";
+    }
+    if (outFile.fail()) {
+        throw std::runtime_error("Failed to write data to file: " + filename);
+    }
+}
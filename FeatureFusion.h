@@ -0,0 +1,87 @@
+/* *******************************************************
+ * Filename		:	FeatureFusion.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	FeatureFusion Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+class LineDetection;
+class CornerDetection;
+
+ /**
+  * @brief A corner together with the line segments meeting at it.
+  *
+  * Every incident segment contributes the ray leaving the corner along it. A segment ending at the
+  * corner gives one ray, a segment passing through it gives two, so its id appears twice. Two rays
+  * make an L, three a T or Y and four an X junction.
+  */
+struct Junction {
+    int corner;                     ///< Index of the corner in CornerDetection::getanalyzeFeatures()
+    std::vector<int> segments;      ///< Segment of every ray, index of the line in LineDetection (endpoints 2i and 2i + 1)
+    std::vector<double> directions; ///< Direction of every ray in degrees in [0, 360), in increasing order
+    std::vector<double> angles;     ///< Angle from every ray to the next one in degrees, the angles sum to 360
+};
+
+/**
+ * @brief The FeatureFusion class.
+ *
+ * Relates the results of LineDetection and CornerDetection. Junctions are found per corner with a box
+ * query on a SegmentIndex over the lines followed by an exact distance check, so extraction takes
+ * O((lines + corners) log lines + incidences) instead of testing every line against every corner.
+ */
+class FeatureFusion {
+public:
+    /**
+     * @brief Extract the junctions from plain feature vectors.
+     * @param segments The line segments as (x1, y1, x2, y2).
+     * @param corners The corners, in the same coordinates as the segments.
+     * @param radius Maximum distance between a corner and a segment in pixels.
+     * @param minRays Minimum number of rays for a junction to be reported.
+     * @return The junctions in corner order.
+     * @throws std::invalid_argument if the radius is not positive.
+     */
+    static std::vector<Junction> extractJunctions(const std::vector<cv::Vec4f>& segments, const std::vector<cv::Point2f>& corners,
+        float radius, int minRays = 2);
+
+    /**
+     * @brief Extract the junctions by testing every segment against every corner.
+     *
+     * Reference for checking and timing extractJunctions(), the result is identical.
+     *
+     * @param segments The line segments as (x1, y1, x2, y2).
+     * @param corners The corners, in the same coordinates as the segments.
+     * @param radius Maximum distance between a corner and a segment in pixels.
+     * @param minRays Minimum number of rays for a junction to be reported.
+     * @return The junctions in corner order.
+     * @throws std::invalid_argument if the radius is not positive.
+     */
+    static std::vector<Junction> extractJunctionsBruteForce(const std::vector<cv::Vec4f>& segments, const std::vector<cv::Point2f>& corners,
+        float radius, int minRays = 2);
+
+    /**
+     * @brief Extract the junctions of two analyzed detectors in reported feature coordinates.
+     *
+     * The line detector's spatial index is reused when it is enabled.
+     *
+     * @param lineDetection Analyzed line detector.
+     * @param cornerDetection Analyzed corner detector of the same image.
+     * @param radius Maximum distance between a corner and a segment in pixels.
+     * @param minRays Minimum number of rays for a junction to be reported.
+     * @return The junctions in corner order.
+     */
+    static std::vector<Junction> extractJunctions(const LineDetection& lineDetection, const CornerDetection& cornerDetection,
+        float radius, int minRays = 2);
+
+    /**
+     * @brief Write junctions with one "corner;segment ...;angle ..." record per line.
+     * @param junctions The junctions.
+     * @param filename The output file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void writeJunctionsToFile(const std::vector<Junction>& junctions, const std::string& filename);
+};
@@ -16,7 +16,18 @@
   *
   * @param filename The filename of the image.
   */
-LineDetection::LineDetection(const std::string& filename) : Detection(filename), threshold(10) {}
+LineDetection::LineDetection(const std::string& filename) : Detection(filename), threshold(defaultThreshold),
+    lineEngine(LineEngine::OpenCVHough),
+    segmentEngine(defaultRho, defaultTheta, defaultHoughThreshold, defaultMinLineLength, defaultMaxLineGap) {}
+
+/**
+ * @brief Constructor that takes an already decoded image.
+ *
+ * @param image The image to be processed.
+ */
+LineDetection::LineDetection(const cv::Mat& image) : Detection(image), threshold(defaultThreshold),
+    lineEngine(LineEngine::OpenCVHough),
+    segmentEngine(defaultRho, defaultTheta, defaultHoughThreshold, defaultMinLineLength, defaultMaxLineGap) {}
 
 /**
  * @brief Setter for the threshold value.
@@ -36,12 +47,67 @@ int LineDetection::getThreshold() const {
     return threshold;
 }
 
+/**
+ * @brief Select the back-end used to extract line segments.
+ *
+ * @param engine The line engine.
+ */
+void LineDetection::setLineEngine(LineEngine engine) {
+    lineEngine = engine;
+}
+
+/**
+ * @brief Get the back-end used to extract line segments.
+ *
+ * @return LineEngine The current line engine.
+ */
+LineEngine LineDetection::getLineEngine() const {
+    return lineEngine;
+}
+
+/**
+ * @brief Get the Hough parameters and alternative back-ends.
+ *
+ * @return LineSegmentEngine& Reference to the segment engine.
+ */
+LineSegmentEngine& LineDetection::getSegmentEngine() {
+    return segmentEngine;
+}
+
+/**
+ * @brief Get the detected lines in working-resolution coordinates.
+ *
+ * @return const std::vector<cv::Vec4i>& The merged lines.
+ */
+const std::vector<cv::Vec4i>& LineDetection::getLines() const {
+    return lines;
+}
+
+/**
+ * @brief Get the spatial index over the detected lines.
+ *
+ * @return const SegmentIndex& The index.
+ * @throws std::logic_error if the spatial index is disabled.
+ */
+const SegmentIndex& LineDetection::getSegmentIndex() const {
+    if (!isSpatialIndexEnabled()) {
+        throw std::logic_error("Spatial index is disabled, call setSpatialIndex(true) before analyzeFeatures()");
+    }
+    return lineIndex;
+}
+
 /**
  * @brief Get the output image containing detected lines.
  *
- * @return cv::Mat The output image with detected lines.
+ * The image is rendered on the first call after analyzeFeatures().
+ *
+ * @return cv::Mat The output image with detected lines, empty in lean mode.
  */
 cv::Mat LineDetection::getOutputImage() const {
+    std::lock_guard<RenderMutex> lock(renderMutex);
+    if (!renderImages()) {
+        return cv::Mat();
+    }
     return output.clone();
 }
 
@@ -69,12 +135,26 @@ double LineDetection::calculateLineAngle(const cv::Vec4i& line) const {
     return std::atan2(pt2.y - pt1.y, pt2.x - pt1.x) * 180.0 / CV_PI;
 }
 
+/**
+ * @brief Map a line from working-resolution coordinates to reported feature coordinates.
+ *
+ * @param line The line in working coordinates.
+ * @return cv::Vec4i The line in reported coordinates.
+ */
+cv::Vec4i LineDetection::toFeatureLine(const cv::Vec4i& line) const {
+    cv::Point2d start = toFeatureCoordinates(cv::Point2d(line[0], line[1]));
+    cv::Point2d end = toFeatureCoordinates(cv::Point2d(line[2], line[3]));
+    return cv::Vec4i(cvRound(start.x), cvRound(start.y), cvRound(end.x), cvRound(end.y));
+}
+
 /**
  * @brief Merge lines that are similar in angle and close in distance.
  *
  * This function applies a merging strategy to similar lines based on angle and distance.
+ *
+ * @param lines The lines, merged in place.
  */
-void LineDetection::mergeLines() {
+void LineDetection::mergeLines(std::vector<cv::Vec4i>& lines) {
     // Thresholds for merging lines
     const double angleThreshold = CV_PI / 180.0 * 8.0;  // Maximum allowed angle difference for merging lines
     const double distanceThreshold = 10.0;  // Maximum allowed distance between lines for merging
@@ -131,7 +211,7 @@ void LineDetection::mergeLines() {
 /**
  * @brief Implement the abstract method for line detection.
  *
- * This function performs line detection using Canny edge detection and Hough Lines.
+ * This function performs line detection using Canny edge detection and the selected line engine.
  */
 void LineDetection::analyzeFeatures() {
     commonOperations();
@@ -140,36 +220,130 @@ void LineDetection::analyzeFeatures() {
     cv::Mat edges;
     cv::Canny(getRGBPic(), edges, getThreshold(), getThreshold() * 3, 3);
 
-    // Probabilistic Hough Transform for line detection
-    cv::HoughLinesP(edges, tempLines, 0.1, CV_PI / 180, 3, 15, 10);
+    // Line segment extraction with the selected engine
+    switch (lineEngine) {
+    case LineEngine::CompactHough:
+        segmentEngine.detectCompactHough(edges, tempLines);
+        break;
+    case LineEngine::SegmentDetector:
+        segmentEngine.detectSegments(getRGBPic(), tempLines);
+        break;
+    default:
+        // Probabilistic Hough Transform for line detection
+        cv::HoughLinesP(edges, tempLines, segmentEngine.getRho(), segmentEngine.getTheta(), segmentEngine.getThreshold(),
+            segmentEngine.getMinLineLength(), segmentEngine.getMaxLineGap());
+        break;
+    }
 
     lines = tempLines;
-    mergeLines();
+    mergeLines(lines);
 
     cannyOutput = edges;
 
-    // Visualization image resizing
-    visualization = getOrginalPic().clone();
-    cv::resize(visualization, visualization, cv::Size(800, 600));
+    // Index the lines in the coordinates getanalyzeFeatures() reports
+    std::vector<cv::Vec4f> indexed;
+    if (isSpatialIndexEnabled()) {
+        indexed.reserve(lines.size());
+        for (const cv::Vec4i& line : lines) {
+            const cv::Vec4i mapped = toFeatureLine(line);
+            indexed.push_back(cv::Vec4f(static_cast<float>(mapped[0]), static_cast<float>(mapped[1]),
+                static_cast<float>(mapped[2]), static_cast<float>(mapped[3])));
+        }
+    }
+    lineIndex.build(indexed);
 
-    // Output image creation
-    output = getRGBPic().clone();
-    cv::cvtColor(output, output, cv::COLOR_GRAY2BGR);
+    // The output and visualization images are rendered on demand
+    {
+        std::lock_guard<RenderMutex> lock(renderMutex);
+        output.release();
+        visualization.release();
+    }
 
-    // Drawing lines on the output image
-    for (size_t i = 0; i < lines.size(); ++i) {
-        cv::Vec4i line = lines[i];
-        cv::Scalar color = cv::Scalar(0, 255, 0);
-        cv::line(output, cv::Point(line[0], line[1]), cv::Point(line[2], line[3]), color, 5);
+    finishProcessing();
+}
+
+/**
+ * @brief Render the output and visualization images if they are not cached yet.
+ *
+ * The lines are drawn on the grayscale working image and the original picture is resized to the
+ * working resolution. Both are kept until the next analyzeFeatures() call. The caller holds
+ * renderMutex, so it can use the images under the same lock.
+ *
+ * @return bool False if the working image was released in lean mode.
+ */
+bool LineDetection::renderImages() const {
+    if (output.empty()) {
+        if (getRGBPic().empty()) {
+            return false;
+        }
+        output = OverlayRenderer::render(getRGBPic(), OverlayRenderer::Lines, lines, std::vector<cv::Point2f>());
+        cv::resize(getOrginalPic(), visualization, getRGBPic().size());
+    }
+    return true;
+}
+
+/**
+ * @brief Copy this detector with its parameters, used to run the cost model probe on.
+ *
+ * @return std::unique_ptr<Detection> The copy.
+ */
+std::unique_ptr<Detection> LineDetection::cloneDetector() const {
+    return std::unique_ptr<Detection>(new LineDetection(*this));
+}
+
+/**
+ * @brief Name the cost model of this detector's configuration.
+ *
+ * The Canny threshold and the Hough parameters change how many edge points vote and how many
+ * segments are traced, so they are part of the name together with the engine.
+ *
+ * @return std::string The base name followed by the engine and its parameters.
+ */
+std::string LineDetection::costModelKey() const {
+    return Detection::costModelKey() + " engine=" + std::to_string(static_cast<int>(lineEngine)) +
+        " threshold=" + std::to_string(threshold) + " rho=" + std::to_string(segmentEngine.getRho()) +
+        " theta=" + std::to_string(segmentEngine.getTheta()) + " votes=" + std::to_string(segmentEngine.getThreshold()) +
+        " length=" + std::to_string(segmentEngine.getMinLineLength()) + " gap=" + std::to_string(segmentEngine.getMaxLineGap());
+}
+
+/**
+ * @brief Release the images and temporary line storage, keeping the merged lines.
+ */
+void LineDetection::releaseIntermediates() {
+    {
+        std::lock_guard<RenderMutex> lock(renderMutex);
+        output.release();
+        visualization.release();
     }
+    cannyOutput.release();
+    std::vector<cv::Vec4i>().swap(tempLines);
+    lines.shrink_to_fit();
+    Detection::releaseIntermediates();
+}
+
+/**
+ * @brief Get the number of bytes held by this object.
+ *
+ * @return size_t The base footprint plus the line images and line containers.
+ */
+size_t LineDetection::memoryFootprint() const {
+    return Detection::memoryFootprint() + sizeof(LineDetection) - sizeof(CommonProcesses) +
+        matBytes(output) + matBytes(cannyOutput) + matBytes(visualization) +
+        (lines.capacity() + tempLines.capacity()) * sizeof(cv::Vec4i) + lineIndex.memoryBytes();
 }
 
 /**
  * @brief Implement the abstract method for visualizing detected lines.
  *
  * This function displays the Canny edges, original picture, and detected lines.
+ *
+ * @throws std::runtime_error if the images were released in lean mode.
  */
 void LineDetection::plotFeatures() const {
+    std::lock_guard<RenderMutex> lock(renderMutex);
+    if (!renderImages()) {
+        throw std::runtime_error("No line images to plot, run analyzeFeatures() without lean mode first");
+    }
     cv::imshow("Canny Edges", cannyOutput);
     cv::imshow("Original Picture", visualization);
     cv::imshow("Detected Lines", output);
@@ -186,10 +360,11 @@ std::vector<std::pair<int, int>> LineDetection::getanalyzeFeatures() const {
 
     for (const cv::Vec4i& line : lines) {
         // Extract coordinates from the cv::Vec4i
-        int x1 = line[0];
-        int y1 = line[1];
-        int x2 = line[2];
-        int y2 = line[3];
+        cv::Vec4i mapped = toFeatureLine(line);
+        int x1 = mapped[0];
+        int y1 = mapped[1];
+        int x2 = mapped[2];
+        int y2 = mapped[3];
 
         // Add the coordinates to the vector
         coordinates.emplace_back(x1, y1);
@@ -212,7 +387,7 @@ std::ostream& operator<<(std::ostream& os, const LineDetection& ld) {
 
     // Iterate through each detected line and display its details
     for (size_t i = 0; i < ld.lines.size(); ++i) {
-        cv::Vec4i line = ld.lines[i];
+        cv::Vec4i line = ld.toFeatureLine(ld.lines[i]);
         double length = ld.calculateLineLength(line);
         double angle = ld.calculateLineAngle(line);
 
@@ -223,7 +398,7 @@ std::ostream& operator<<(std::ostream& os, const LineDetection& ld) {
         os << "  Angle:       " << angle << " degrees\n";
         os << "-------------------------\n";
     }
-    os << "Detected lines: " << ld.lines.size() << std::endl;
+    os << "Detected lines: " << ld.lines.size() << "\n";
 
     return os;
 }
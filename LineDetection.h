@@ -7,8 +7,12 @@
 
 #pragma once
 #include "Detection.h"
+#include "LineSegmentEngine.h"
+#include "OverlayRenderer.h"
+#include "SegmentIndex.h"
 #include <opencv2/imgproc.hpp>
 #include <algorithm>
+#include <mutex>
 
  /**
   * @brief The LineDetection class.
@@ -16,16 +20,28 @@
   * A derived class from the Detection base class, specializing in detecting and visualizing lines in an image.
   */
 class LineDetection : public Detection {
+public:
+    static constexpr int defaultThreshold = 10;             ///< Default lower Canny threshold, the upper one is three times larger
+    static constexpr double defaultRho = 0.1;               ///< Default Hough distance resolution in pixels
+    static constexpr double defaultTheta = CV_PI / 180;     ///< Default Hough angle resolution in radians
+    static constexpr int defaultHoughThreshold = 3;         ///< Default Hough accumulator threshold
+    static constexpr double defaultMinLineLength = 15;      ///< Default minimum segment length
+    static constexpr double defaultMaxLineGap = 10;         ///< Default maximum gap between points on one segment
+
 private:
-    cv::Mat output;         ///< Output image containing detected lines
+    mutable cv::Mat output;         ///< Output image containing detected lines, rendered on first use
 
     int threshold;          ///< Threshold for line detection
     std::vector<cv::Vec4i> lines;   ///< Detected lines in the image
-    cv::Mat edges;          ///< Image edges after Canny edge detection
     cv::Mat cannyOutput;    ///< Temporary storage for Canny output
     std::vector<cv::Vec4i> tempLines;  ///< Temporary storage for detected lines
 
-    cv::Mat visualization;  ///< Image used for visualization purposes
+    mutable cv::Mat visualization;  ///< Image used for visualization purposes, rendered on first use
+    mutable RenderMutex renderMutex;    ///< Guards the lazily rendered images
+
+    LineEngine lineEngine;              ///< Back-end used to extract line segments
+    LineSegmentEngine segmentEngine;    ///< Hough parameters and alternative back-ends
+    SegmentIndex lineIndex;             ///< Spatial index over the lines in reported coordinates
 
     /**
      * @brief Calculate the length of a line.
@@ -44,9 +60,37 @@ private:
     double calculateLineAngle(const cv::Vec4i& line) const;
 
     /**
-     * @brief Merge lines that are close to each other.
+     * @brief Map a line from working-resolution coordinates to reported feature coordinates.
+     *
+     * @param line The line in working coordinates.
+     * @return The line in original-image coordinates in budget mode, unchanged otherwise.
+     */
+    cv::Vec4i toFeatureLine(const cv::Vec4i& line) const;
+
+    /**
+     * @brief Render the output and visualization images if they are not cached yet.
+     *
+     * The caller must hold renderMutex.
+     *
+     * @return False if the working image was released in lean mode and nothing can be rendered.
      */
-    void mergeLines();
+    bool renderImages() const;
+
+protected:
+    /**
+     * @brief Release the images and temporary line storage, keeping the merged lines.
+     */
+    void releaseIntermediates() override;
+
+    /**
+     * @brief Copy this detector with its parameters, used to run the cost model probe on.
+     */
+    std::unique_ptr<Detection> cloneDetector() const override;
+
+    /**
+     * @brief Name the cost model of this detector's configuration, including the line engine and its parameters.
+     */
+    std::string costModelKey() const override;
 
 public:
     /**
@@ -56,6 +100,13 @@ public:
      */
     LineDetection(const std::string& filename);
 
+    /**
+     * @brief Constructor for the LineDetection class that takes an already decoded image.
+     *
+     * @param image The image to be processed.
+     */
+    LineDetection(const cv::Mat& image);
+
     /**
      * @brief Destructor for the LineDetection class.
      */
@@ -75,6 +126,58 @@ public:
      */
     int getThreshold() const;
 
+    /**
+     * @brief Select the back-end used to extract line segments.
+     *
+     * @param engine The line engine.
+     */
+    void setLineEngine(LineEngine engine);
+
+    /**
+     * @brief Get the back-end used to extract line segments.
+     *
+     * @return The line engine.
+     */
+    LineEngine getLineEngine() const;
+
+    /**
+     * @brief Get the Hough parameters and alternative back-ends, e.g. to change the memory budget.
+     *
+     * @return Reference to the segment engine.
+     */
+    LineSegmentEngine& getSegmentEngine();
+
+    /**
+     * @brief Get the detected lines in working-resolution coordinates.
+     *
+     * @return Reference to the merged lines.
+     */
+    const std::vector<cv::Vec4i>& getLines() const;
+
+    /**
+     * @brief Merge lines that are close to each other.
+     *
+     * @param lines The lines, merged in place.
+     */
+    static void mergeLines(std::vector<cv::Vec4i>& lines);
+
+    /**
+     * @brief Get the spatial index over the detected lines.
+     *
+     * Segment i of the index is the line formed by the endpoints 2i and 2i + 1 of getanalyzeFeatures().
+     *
+     * @return Reference to the index.
+     * @throws std::logic_error if the spatial index is disabled.
+     */
+    const SegmentIndex& getSegmentIndex() const;
+
+    /**
+     * @brief Get the number of bytes held by this object.
+     *
+     * @return The memory footprint in bytes.
+     */
+    size_t memoryFootprint() const override;
+
     /**
      * @brief Implement the abstract method for line detection.
      */
@@ -95,7 +198,7 @@ public:
     /**
      * @brief Implement the abstract method for getting the output image.
      *
-     * @return The output image containing detected lines.
+     * @return The output image containing detected lines, empty in lean mode.
      */
     cv::Mat getOutputImage() const override;
 
@@ -0,0 +1,398 @@
+/* *******************************************************
+ * Filename		:	LineSegmentEngine.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	LineSegmentEngine Class Implementation
+ * ******************************************************/
+
+#include "LineSegmentEngine.h"
+#include "ParallelLoop.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+ /**
+  * @brief Constructor that takes the Hough parameters.
+  *
+  * The compact engine starts with a 1 MiB accumulator budget, while cv::HoughLinesP needs about
+  * 20 MiB for the 800x600 working images. Larger accumulators are voted in tiles over the rho range.
+  */
+LineSegmentEngine::LineSegmentEngine(double rho, double theta, int threshold, double minLineLength, double maxLineGap)
+    : rho(rho), theta(theta), threshold(threshold), minLineLength(minLineLength), maxLineGap(maxLineGap),
+    memoryBudget(1 << 20), rhoTiles(0), workingBytes(0) {
+    if (rho <= 0 || theta <= 0 || threshold <= 0) {
+        throw std::invalid_argument("Hough rho, theta and threshold must be positive");
+    }
+}
+
+/**
+ * @brief Set the accumulator memory budget.
+ *
+ * @param bytes Upper bound in bytes.
+ * @throws std::invalid_argument if the budget is zero.
+ */
+void LineSegmentEngine::setMemoryBudget(size_t bytes) {
+    if (bytes == 0) {
+        throw std::invalid_argument("Accumulator memory budget must be positive");
+    }
+    memoryBudget = bytes;
+}
+
+/**
+ * @brief Get the accumulator memory budget.
+ *
+ * @return The budget in bytes.
+ */
+size_t LineSegmentEngine::getMemoryBudget() const {
+    return memoryBudget;
+}
+
+/**
+ * @brief Get the requested distance resolution.
+ *
+ * @return Rho in pixels.
+ */
+double LineSegmentEngine::getRho() const {
+    return rho;
+}
+
+/**
+ * @brief Get the angle resolution.
+ *
+ * @return Theta in radians.
+ */
+double LineSegmentEngine::getTheta() const {
+    return theta;
+}
+
+/**
+ * @brief Get the accumulator threshold.
+ *
+ * @return The minimum number of votes.
+ */
+int LineSegmentEngine::getThreshold() const {
+    return threshold;
+}
+
+/**
+ * @brief Get the minimum segment length.
+ *
+ * @return The length in pixels.
+ */
+double LineSegmentEngine::getMinLineLength() const {
+    return minLineLength;
+}
+
+/**
+ * @brief Get the maximum gap between points on the same segment.
+ *
+ * @return The gap in pixels.
+ */
+double LineSegmentEngine::getMaxLineGap() const {
+    return maxLineGap;
+}
+
+/**
+ * @brief Get the number of rho tiles the last compact Hough run voted in.
+ *
+ * @return The number of tiles.
+ */
+int LineSegmentEngine::getRhoTiles() const {
+    return rhoTiles;
+}
+
+/**
+ * @brief Get the working memory held by the last run.
+ *
+ * @return The number of bytes.
+ */
+size_t LineSegmentEngine::getWorkingBytes() const {
+    return workingBytes;
+}
+
+/**
+ * @brief Detect segments with the compact Hough engine.
+ *
+ * Voting runs in parallel over ranges of angles into a 16-bit accumulator, each range owning its rows.
+ * When the accumulator at the requested rho does not fit the memory budget, the rho range is split
+ * into tiles that are voted one after another, so the bins keep the requested size and every tile
+ * costs one more pass over the edge points. Local maxima above the threshold are then visited strongest first, and each one is walked
+ * through the edge map to extract segments. Pixels that end up in a segment are removed from
+ * the map so weaker neighbouring peaks do not report the same segment again.
+ *
+ * @param edges Binary 8-bit edge image.
+ * @param segments Output vector of detected segments.
+ * @throws std::invalid_argument if the edge image is empty or not 8-bit single channel.
+ */
+void LineSegmentEngine::detectCompactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments) {
+    std::vector<uint16_t> accumulator;
+    compactHough(edges, segments, accumulator, true);
+}
+
+/**
+ * @brief Detect segments with the compact Hough engine, voting into a caller-owned accumulator.
+ *
+ * @param edges Binary 8-bit edge image.
+ * @param segments Output vector of detected segments.
+ * @param accumulator Reusable vote buffer.
+ * @throws std::invalid_argument if the edge image is empty or not 8-bit single channel.
+ */
+void LineSegmentEngine::detectCompactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments, std::vector<uint16_t>& accumulator) {
+    compactHough(edges, segments, accumulator, false);
+}
+
+/**
+ * @brief Get the number of accumulator cells the compact engine uses for an edge image.
+ *
+ * @return size_t The number of 16-bit cells.
+ */
+size_t LineSegmentEngine::accumulatorCells(const cv::Size& size) const {
+    int tileBins = 0;
+    const int numAngle = std::max(1, cvRound(CV_PI / theta));
+    rhoLayout(size, tileBins);
+    return static_cast<size_t>(numAngle) * (tileBins + 2);
+}
+
+/**
+ * @brief Split the rho range of the compact accumulator into tiles that fit the memory budget.
+ *
+ * Every tile row holds its own bins plus one neighbour bin on each side for the local maximum test,
+ * so a tile owns at least one bin even if the budget is smaller than three cells per angle.
+ *
+ * @return int The number of rho bins on each side of the origin.
+ */
+int LineSegmentEngine::rhoLayout(const cv::Size& size, int& tileBins) const {
+    const int numAngle = std::max(1, cvRound(CV_PI / theta));
+    const double maxDistance = std::sqrt(static_cast<double>(size.width) * size.width + static_cast<double>(size.height) * size.height);
+    const int rhoOffset = cvCeil(maxDistance / rho);
+    const size_t budgetCells = memoryBudget / sizeof(uint16_t) / numAngle;
+    tileBins = static_cast<int>(std::min<size_t>(2 * rhoOffset + 1, std::max<size_t>(3, budgetCells) - 2));
+    return rhoOffset;
+}
+
+/**
+ * @brief Run the compact Hough engine, see detectCompactHough().
+ *
+ * The accumulator keeps its capacity between calls unless releaseVotes is set, in which case it is
+ * freed before the extraction so that votes and edge mask are never held at the same time.
+ */
+void LineSegmentEngine::compactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments, std::vector<uint16_t>& accumulator, bool releaseVotes) {
+    if (edges.empty() || edges.type() != CV_8UC1) {
+        throw std::invalid_argument("Compact Hough expects a non-empty 8-bit single channel edge image");
+    }
+    segments.clear();
+
+    std::vector<cv::Point> points;
+    cv::findNonZero(edges, points);
+
+    const int numAngle = std::max(1, cvRound(CV_PI / theta));
+    int tileBins = 0;
+    const int rhoOffset = rhoLayout(edges.size(), tileBins);
+    const int numRho = 2 * rhoOffset + 1;
+    const int tileWidth = tileBins + 2;
+    const size_t cells = static_cast<size_t>(numAngle) * tileWidth;
+    rhoTiles = (numRho + tileBins - 1) / tileBins;
+
+    std::vector<float> cosTable(numAngle), sinTable(numAngle);
+    for (int n = 0; n < numAngle; ++n) {
+        cosTable[n] = static_cast<float>(std::cos(n * theta) / rho);
+        sinTable[n] = static_cast<float>(std::sin(n * theta) / rho);
+    }
+
+    struct Peak {
+        int votes;
+        int angleIndex;
+        int rhoIndex;
+    };
+    std::vector<Peak> peaks;
+
+    for (int tileStart = 0; tileStart < numRho; tileStart += tileBins) {
+        const int tileEnd = std::min(numRho, tileStart + tileBins);
+        // Column 0 of a tile row is the bin before tileStart, so the neighbours of every owned bin are present.
+        const int firstBin = tileStart - 1;
+        accumulator.assign(cells, 0);
+
+        // Every stripe owns a range of angles, i.e. whole accumulator rows, and votes with all points into
+        // them, so no two threads ever write the same cell and no atomics or merge pass are needed.
+        ParallelLoop::run(cv::Range(0, numAngle), [&](const cv::Range& range) {
+            for (int n = range.start; n < range.end; ++n) {
+                uint16_t* row = accumulator.data() + static_cast<size_t>(n) * tileWidth;
+                const float cosValue = cosTable[n];
+                const float sinValue = sinTable[n];
+                for (const cv::Point& pt : points) {
+                    const unsigned column = static_cast<unsigned>(cvRound(pt.x * cosValue + pt.y * sinValue) + rhoOffset - firstBin);
+                    if (column >= static_cast<unsigned>(tileWidth)) {
+                        continue;
+                    }
+                    uint16_t& votes = row[column];
+                    // Saturating increment, a bin can never need more than 65535 votes to pass the threshold.
+                    if (votes < std::numeric_limits<uint16_t>::max()) {
+                        ++votes;
+                    }
+                }
+            }
+        });
+
+        // Collect local maxima of the bins this tile owns.
+        for (int n = 0; n < numAngle; ++n) {
+            for (int r = tileStart; r < tileEnd; ++r) {
+                const int votes = accumulator[static_cast<size_t>(n) * tileWidth + (r - firstBin)];
+                if (votes < threshold) {
+                    continue;
+                }
+
+                bool isMaximum = true;
+                for (int dn = -1; dn <= 1 && isMaximum; ++dn) {
+                    for (int dr = -1; dr <= 1 && isMaximum; ++dr) {
+                        const int nn = n + dn;
+                        const int rr = r + dr;
+                        if ((dn == 0 && dr == 0) || nn < 0 || nn >= numAngle || rr < 0 || rr >= numRho) {
+                            continue;
+                        }
+                        const int neighbour = accumulator[static_cast<size_t>(nn) * tileWidth + (rr - firstBin)];
+                        // Ties are resolved in favour of the bin that comes first in angle-major order.
+                        bool visitedBefore = dn < 0 || (dn == 0 && dr < 0);
+                        isMaximum = visitedBefore ? votes > neighbour : votes >= neighbour;
+                    }
+                }
+                if (isMaximum) {
+                    peaks.push_back({ votes, n, r });
+                }
+            }
+        }
+    }
+
+    const size_t votingBytes = cells * sizeof(uint16_t) + points.capacity() * sizeof(cv::Point) +
+        (cosTable.capacity() + sinTable.capacity()) * sizeof(float);
+    if (releaseVotes) {
+        std::vector<uint16_t>().swap(accumulator);
+    }
+
+    // Equal votes keep the angle-major order of an untiled accumulator, whatever the tile layout.
+    std::sort(peaks.begin(), peaks.end(), [](const Peak& a, const Peak& b) {
+        if (a.votes != b.votes) {
+            return a.votes > b.votes;
+        }
+        return a.angleIndex != b.angleIndex ? a.angleIndex < b.angleIndex : a.rhoIndex < b.rhoIndex;
+    });
+
+    cv::Mat mask = edges.clone();
+    for (const Peak& peak : peaks) {
+        extractSegments(mask, peak.angleIndex * theta, (peak.rhoIndex - rhoOffset) * rho, segments);
+    }
+
+    const size_t extractionBytes = peaks.capacity() * sizeof(Peak) + mask.total() * mask.elemSize() +
+        points.capacity() * sizeof(cv::Point) + accumulator.capacity() * sizeof(uint16_t);
+    workingBytes = std::max(votingBytes, extractionBytes);
+}
+
+/**
+ * @brief Walk a line through the edge mask and emit the segments found on it.
+ *
+ * The walk steps one pixel at a time along the dominant axis of the line. A step hits when an
+ * edge pixel lies inside the accumulator bin's band around the line. Runs of hits separated by
+ * at most maxLineGap misses form a segment, which is kept when it has at least threshold pixels
+ * and is at least minLineLength long.
+ */
+void LineSegmentEngine::extractSegments(cv::Mat& mask, double angle, double distance, std::vector<cv::Vec4i>& segments) const {
+    const double c = std::cos(angle);
+    const double s = std::sin(angle);
+
+    // Step along x for lines closer to horizontal, along y otherwise.
+    const bool walkX = std::abs(s) > std::abs(c);
+    const int steps = walkX ? mask.cols : mask.rows;
+    const double minorScale = walkX ? std::abs(s) : std::abs(c);
+    const int band = cvRound(rho / (2.0 * minorScale) - 0.5);
+    const int maxGap = cvRound(maxLineGap);
+
+    std::vector<cv::Point> hits;
+    int gap = 0;
+
+    auto flush = [&]() {
+        if (static_cast<int>(hits.size()) >= threshold) {
+            const cv::Point& first = hits.front();
+            const cv::Point& last = hits.back();
+            if (cv::norm(last - first) >= minLineLength) {
+                segments.push_back(cv::Vec4i(first.x, first.y, last.x, last.y));
+                for (const cv::Point& p : hits) {
+                    mask.at<uchar>(p.y, p.x) = 0;
+                }
+            }
+        }
+        hits.clear();
+        gap = 0;
+    };
+
+    for (int t = 0; t < steps; ++t) {
+        const double minor = walkX ? (distance - t * c) / s : (distance - t * s) / c;
+        const int base = cvRound(minor);
+
+        bool hit = false;
+        // Probe the centre pixel first, then alternate outwards inside the band.
+        for (int k = 0; k <= 2 * band && !hit; ++k) {
+            const int m = base + ((k & 1) ? -((k + 1) / 2) : k / 2);
+            const cv::Point p = walkX ? cv::Point(t, m) : cv::Point(m, t);
+            if (p.x < 0 || p.y < 0 || p.x >= mask.cols || p.y >= mask.rows) {
+                continue;
+            }
+            if (mask.at<uchar>(p.y, p.x)) {
+                hits.push_back(p);
+                hit = true;
+            }
+        }
+
+        if (hit) {
+            gap = 0;
+        }
+        else if (!hits.empty() && ++gap > maxGap) {
+            flush();
+        }
+    }
+    flush();
+}
+
+/**
+ * @brief Detect segments with the LSD line segment detector.
+ *
+ * LSD works on the grayscale image directly instead of a Canny edge map, which makes it the
+ * fast alternative to the Hough engines. Segments shorter than minLineLength are dropped so
+ * the output is comparable with the Hough back-ends.
+ */
+void LineSegmentEngine::detectSegments(const cv::Mat& gray, std::vector<cv::Vec4i>& segments) {
+    if (gray.empty() || gray.type() != CV_8UC1) {
+        throw std::invalid_argument("Segment detector expects a non-empty 8-bit grayscale image");
+    }
+
+    cv::Ptr<cv::LineSegmentDetector> detector = cv::createLineSegmentDetector(cv::LSD_REFINE_STD);
+    std::vector<cv::Vec4f> found;
+    detector->detect(gray, found);
+
+    segments.clear();
+    segments.reserve(found.size());
+    for (const cv::Vec4f& segment : found) {
+        cv::Vec4i rounded(cvRound(segment[0]), cvRound(segment[1]), cvRound(segment[2]), cvRound(segment[3]));
+        if (cv::norm(cv::Point(rounded[0], rounded[1]) - cv::Point(rounded[2], rounded[3])) >= minLineLength) {
+            segments.push_back(rounded);
+        }
+    }
+
+    // LSD keeps a scaled double image, gradient magnitude, level-line angles and a used-pixel map.
+    workingBytes = gray.total() * (3 * sizeof(double) + 1) + found.capacity() * sizeof(cv::Vec4f);
+}
+
+/**
+ * @brief Estimate the working memory cv::HoughLinesP allocates.
+ *
+ * Mirrors the allocations of OpenCV's progressive probabilistic Hough transform: an int
+ * accumulator of numangle x numrho cells, a byte mask of the image, the trigonometric table
+ * and the list of edge pixel locations.
+ */
+size_t LineSegmentEngine::estimateOpenCVHoughBytes(cv::Size size, size_t edgePoints, double rho, double theta) {
+    const size_t numAngle = static_cast<size_t>(cvRound(CV_PI / theta));
+    const size_t numRho = static_cast<size_t>(cvRound(((size.width + size.height) * 2 + 1) / rho));
+    return numAngle * numRho * sizeof(int) + static_cast<size_t>(size.area()) +
+        numAngle * 2 * sizeof(float) + edgePoints * sizeof(cv::Point);
+}
@@ -0,0 +1,189 @@
+/* *******************************************************
+ * Filename		:	LineSegmentEngine.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	LineSegmentEngine Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+ /**
+  * @brief Line segment extraction back-ends selectable by LineDetection.
+  */
+enum class LineEngine {
+    OpenCVHough,        ///< cv::HoughLinesP with the configured parameters
+    CompactHough,       ///< Memory-bounded accumulator with parallel voting
+    SegmentDetector     ///< Fast LSD line segment detector working on the grayscale image
+};
+
+/**
+ * @brief The LineSegmentEngine class.
+ *
+ * Holds the Hough parameters used by LineDetection and implements the alternative line segment
+ * back-ends. The compact Hough engine keeps its accumulator within a memory budget by voting in tiles
+ * over the rho range when needed, votes in parallel with every thread owning a range of angles and then
+ * walks each accumulator peak through the edge map to extract segments with the same
+ * minimum length and maximum gap rules as cv::HoughLinesP.
+ */
+class LineSegmentEngine {
+private:
+    double rho;             ///< Requested distance resolution of the accumulator in pixels
+    double theta;           ///< Angle resolution of the accumulator in radians
+    int threshold;          ///< Minimum number of votes (and edge pixels) for a segment
+    double minLineLength;   ///< Minimum segment length
+    double maxLineGap;      ///< Maximum allowed gap between points on the same segment
+
+    size_t memoryBudget;    ///< Upper bound for the accumulator size in bytes
+    int rhoTiles;           ///< Number of rho tiles the last compact run voted in
+    size_t workingBytes;    ///< Working memory held by the last run
+
+    /**
+     * @brief Walk a line through the edge mask and emit the segments found on it.
+     *
+     * @param mask Edge pixels that are still unassigned, consumed pixels are cleared.
+     * @param angle Normal angle of the line in radians.
+     * @param distance Signed distance of the line from the origin.
+     * @param segments Output vector the segments are appended to.
+     */
+    void extractSegments(cv::Mat& mask, double angle, double distance, std::vector<cv::Vec4i>& segments) const;
+
+    /**
+     * @brief Split the rho range of the compact accumulator into tiles that fit the memory budget.
+     *
+     * @param size Size of the edge image.
+     * @param tileBins Receives the number of rho bins owned by one tile.
+     * @return The number of rho bins on each side of the origin.
+     */
+    int rhoLayout(const cv::Size& size, int& tileBins) const;
+
+    /**
+     * @brief Run the compact Hough engine.
+     *
+     * @param edges Binary 8-bit edge image.
+     * @param segments Output vector of detected segments.
+     * @param accumulator Vote buffer, reallocated only when it is too small.
+     * @param releaseVotes Free the accumulator before the segments are extracted.
+     */
+    void compactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments, std::vector<uint16_t>& accumulator, bool releaseVotes);
+
+public:
+    /**
+     * @brief Constructor that takes the Hough parameters.
+     *
+     * @param rho Distance resolution in pixels.
+     * @param theta Angle resolution in radians.
+     * @param threshold Accumulator threshold.
+     * @param minLineLength Minimum segment length.
+     * @param maxLineGap Maximum gap between points on the same segment.
+     */
+    LineSegmentEngine(double rho, double theta, int threshold, double minLineLength, double maxLineGap);
+
+    /**
+     * @brief Set the accumulator memory budget of the compact engine.
+     *
+     * @param bytes Upper bound in bytes, must be positive.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Get the accumulator memory budget of the compact engine.
+     *
+     * @return The budget in bytes.
+     */
+    size_t getMemoryBudget() const;
+
+    /**
+     * @brief Get the requested distance resolution.
+     * @return Rho in pixels.
+     */
+    double getRho() const;
+
+    /**
+     * @brief Get the angle resolution.
+     * @return Theta in radians.
+     */
+    double getTheta() const;
+
+    /**
+     * @brief Get the accumulator threshold.
+     * @return The minimum number of votes.
+     */
+    int getThreshold() const;
+
+    /**
+     * @brief Get the minimum segment length.
+     * @return The length in pixels.
+     */
+    double getMinLineLength() const;
+
+    /**
+     * @brief Get the maximum gap between points on the same segment.
+     * @return The gap in pixels.
+     */
+    double getMaxLineGap() const;
+
+    /**
+     * @brief Get the number of rho tiles the last compact Hough run voted in.
+     *
+     * @return The number of tiles, 1 if the whole accumulator fit the budget.
+     */
+    int getRhoTiles() const;
+
+    /**
+     * @brief Get the working memory held by the last run.
+     *
+     * @return The number of bytes.
+     */
+    size_t getWorkingBytes() const;
+
+    /**
+     * @brief Detect segments with the compact Hough engine.
+     *
+     * @param edges Binary 8-bit edge image.
+     * @param segments Output vector of detected segments.
+     */
+    void detectCompactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments);
+
+    /**
+     * @brief Detect segments with the compact Hough engine, voting into a caller-owned accumulator.
+     *
+     * A caller processing many edge images of bounded size can reserve accumulatorCells() once and
+     * reuse the buffer for all of them.
+     *
+     * @param edges Binary 8-bit edge image.
+     * @param segments Output vector of detected segments.
+     * @param accumulator Reusable vote buffer, reallocated only when it is too small.
+     */
+    void detectCompactHough(const cv::Mat& edges, std::vector<cv::Vec4i>& segments, std::vector<uint16_t>& accumulator);
+
+    /**
+     * @brief Get the number of accumulator cells the compact engine uses for an edge image.
+     *
+     * @param size Size of the edge image.
+     * @return The number of 16-bit cells of one tile, bounded by the memory budget.
+     */
+    size_t accumulatorCells(const cv::Size& size) const;
+
+    /**
+     * @brief Detect segments with the LSD line segment detector.
+     *
+     * @param gray 8-bit grayscale image.
+     * @param segments Output vector of segments at least minLineLength long.
+     */
+    void detectSegments(const cv::Mat& gray, std::vector<cv::Vec4i>& segments);
+
+    /**
+     * @brief Estimate the working memory cv::HoughLinesP allocates for the given input.
+     *
+     * @param size Size of the edge image.
+     * @param edgePoints Number of non-zero edge pixels.
+     * @param rho Distance resolution in pixels.
+     * @param theta Angle resolution in radians.
+     * @return The estimated number of bytes.
+     */
+    static size_t estimateOpenCVHoughBytes(cv::Size size, size_t edgePoints, double rho, double theta);
+};
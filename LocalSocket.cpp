@@ -0,0 +1,363 @@
+/* *******************************************************
+ * Filename		:	LocalSocket.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	LocalSocket Class Implementation
+ * ******************************************************/
+
+#include "LocalSocket.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET NativeSocket;
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <unistd.h>
+typedef int NativeSocket;
+#endif
+
+// Windows has no SIGPIPE and macOS sets SO_NOSIGPIPE on the socket instead, see suppressSigpipe().
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+    /**
+     * @brief Initialize Winsock once per process, no-op elsewhere.
+     */
+    void initializeSockets() {
+#ifdef _WIN32
+        static const bool initialized = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        if (!initialized) {
+            throw std::runtime_error("Could not initialize Winsock");
+        }
+#endif
+    }
+
+    /**
+     * @brief Fill a Unix domain socket address.
+     * @param path The socket path.
+     * @return The address.
+     * @throws std::runtime_error if the path is too long.
+     */
+    sockaddr_un makeAddress(const std::string& path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path is too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        return address;
+    }
+
+    /**
+     * @brief Keep writes to a closed peer from raising SIGPIPE where send() has no MSG_NOSIGNAL flag.
+     * @param handle The connected socket handle.
+     */
+    void suppressSigpipe(intptr_t handle) {
+#ifdef SO_NOSIGPIPE
+        int enabled = 1;
+        setsockopt(static_cast<NativeSocket>(handle), SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#else
+        (void)handle;
+#endif
+    }
+
+    /**
+     * @brief Close a native socket handle.
+     * @param handle The handle.
+     */
+    void closeHandle(intptr_t handle) {
+#ifdef _WIN32
+        closesocket(static_cast<NativeSocket>(handle));
+#else
+        ::close(static_cast<NativeSocket>(handle));
+#endif
+    }
+}
+
+/**
+ * @brief Constructor that creates a closed socket.
+ */
+LocalSocket::LocalSocket() : handle(-1) {}
+
+/**
+ * @brief Constructor that takes ownership of a native handle.
+ *
+ * @param nativeHandle The socket handle.
+ */
+LocalSocket::LocalSocket(intptr_t nativeHandle) : handle(nativeHandle) {}
+
+/**
+ * @brief Destructor, closes the socket.
+ */
+LocalSocket::~LocalSocket() {
+    close();
+}
+
+/**
+ * @brief Move constructor, takes over the handle and the buffered bytes.
+ */
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept : handle(other.handle), buffer(std::move(other.buffer)) {
+    other.handle = -1;
+}
+
+/**
+ * @brief Move assignment, closes the current handle first.
+ */
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        buffer = std::move(other.buffer);
+        other.handle = -1;
+    }
+    return *this;
+}
+
+/**
+ * @brief Create a listening socket bound to a path.
+ *
+ * @return LocalSocket The listening socket.
+ */
+LocalSocket LocalSocket::listen(const std::string& path, int backlog) {
+    initializeSockets();
+    sockaddr_un address = makeAddress(path);
+    std::remove(path.c_str());
+
+    LocalSocket listener(static_cast<intptr_t>(::socket(AF_UNIX, SOCK_STREAM, 0)));
+    if (listener.handle < 0) {
+        throw std::runtime_error("Could not create the socket: " + path);
+    }
+    if (::bind(static_cast<NativeSocket>(listener.handle), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(static_cast<NativeSocket>(listener.handle), backlog) != 0) {
+        throw std::runtime_error("Could not listen on the socket: " + path);
+    }
+    return listener;
+}
+
+/**
+ * @brief Connect to a listening socket.
+ *
+ * @return LocalSocket The connected socket.
+ */
+LocalSocket LocalSocket::connect(const std::string& path) {
+    initializeSockets();
+    sockaddr_un address = makeAddress(path);
+
+    LocalSocket connection(static_cast<intptr_t>(::socket(AF_UNIX, SOCK_STREAM, 0)));
+    if (connection.handle < 0 ||
+        ::connect(static_cast<NativeSocket>(connection.handle), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("Could not connect to the socket: " + path);
+    }
+    suppressSigpipe(connection.handle);
+    return connection;
+}
+
+/**
+ * @brief Wait for the next connection.
+ *
+ * @return LocalSocket The connected socket.
+ */
+LocalSocket LocalSocket::accept() {
+    intptr_t client = static_cast<intptr_t>(::accept(static_cast<NativeSocket>(handle), nullptr, nullptr));
+    if (client < 0) {
+        return LocalSocket();
+    }
+    suppressSigpipe(client);
+    return LocalSocket(client);
+}
+
+/**
+ * @brief Receive more bytes into the buffer.
+ *
+ * @return bool False on end of stream or error.
+ */
+bool LocalSocket::fill() {
+    char chunk[65536];
+    int received = static_cast<int>(::recv(static_cast<NativeSocket>(handle), chunk, sizeof(chunk), 0));
+    if (received <= 0) {
+        return false;
+    }
+    buffer.append(chunk, received);
+    return true;
+}
+
+/**
+ * @brief Read one line without its terminating newline.
+ *
+ * A peer that keeps sending without a newline cannot grow the buffer past maxLength.
+ *
+ * @return bool False on end of stream before a full line or if the line is too long.
+ */
+bool LocalSocket::readLine(std::string& line, size_t maxLength) {
+    size_t end;
+    while ((end = buffer.find('\n')) == std::string::npos) {
+        if (buffer.size() > maxLength || !fill()) {
+            return false;
+        }
+    }
+    if (end > maxLength) {
+        return false;
+    }
+    line.assign(buffer, 0, end);
+    buffer.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return true;
+}
+
+/**
+ * @brief Read an exact number of bytes.
+ *
+ * @return bool False on end of stream before all bytes arrived.
+ */
+bool LocalSocket::readExact(std::vector<unsigned char>& data, size_t size) {
+    data.resize(size);
+    size_t copied = std::min(size, buffer.size());
+    std::memcpy(data.data(), buffer.data(), copied);
+    buffer.erase(0, copied);
+
+    while (copied < size) {
+        int received = static_cast<int>(::recv(static_cast<NativeSocket>(handle), reinterpret_cast<char*>(data.data()) + copied,
+            static_cast<int>(std::min<size_t>(size - copied, 1 << 20)), 0));
+        if (received <= 0) {
+            return false;
+        }
+        copied += received;
+    }
+    return true;
+}
+
+/**
+ * @brief Write all bytes.
+ *
+ * @return bool False if the peer closed the connection.
+ */
+bool LocalSocket::writeAll(const char* data, size_t size) {
+    while (size > 0) {
+        int sent = static_cast<int>(::send(static_cast<NativeSocket>(handle), data, static_cast<int>(std::min<size_t>(size, 1 << 20)), MSG_NOSIGNAL));
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+/**
+ * @brief Write a string.
+ *
+ * @return bool False if the peer closed the connection.
+ */
+bool LocalSocket::writeAll(const std::string& data) {
+    return writeAll(data.data(), data.size());
+}
+
+/**
+ * @brief Limit how long a read may wait for data.
+ *
+ * A read that times out fails like a closed connection.
+ *
+ * @param milliseconds The timeout, 0 waits forever.
+ */
+void LocalSocket::setReadTimeout(int milliseconds) {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(milliseconds);
+#else
+    timeval timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = (milliseconds % 1000) * 1000;
+#endif
+    setsockopt(static_cast<NativeSocket>(handle), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+/**
+ * @brief Check whether received bytes are buffered that no read has consumed yet.
+ *
+ * Such bytes never make the socket readable again, so a caller that waits with waitReadable()
+ * must serve them first.
+ *
+ * @return bool True if the next read can start without waiting for the peer.
+ */
+bool LocalSocket::hasBufferedData() const {
+    return !buffer.empty();
+}
+
+/**
+ * @brief Receive and drop the bytes that are available, waiting for at least one.
+ *
+ * @return bool False on end of stream or error.
+ */
+bool LocalSocket::discard() {
+    const bool received = fill();
+    buffer.clear();
+    return received;
+}
+
+/**
+ * @brief Wait until at least one socket is readable, closed by the peer or failed.
+ *
+ * @return bool False if waiting failed.
+ */
+bool LocalSocket::waitReadable(const std::vector<const LocalSocket*>& sockets, std::vector<char>& readable) {
+#ifdef _WIN32
+    std::vector<WSAPOLLFD> descriptors(sockets.size());
+#else
+    std::vector<pollfd> descriptors(sockets.size());
+#endif
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        descriptors[i].fd = static_cast<NativeSocket>(sockets[i]->handle);
+        descriptors[i].events = POLLIN;
+        descriptors[i].revents = 0;
+    }
+#ifdef _WIN32
+    const int ready = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), -1);
+#else
+    const int ready = ::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), -1);
+#endif
+    readable.assign(sockets.size(), 0);
+    if (ready < 0) {
+        return false;
+    }
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        readable[i] = (descriptors[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether the socket is open.
+ *
+ * @return bool True if the socket holds a handle.
+ */
+bool LocalSocket::isOpen() const {
+    return handle >= 0;
+}
+
+/**
+ * @brief Close the socket.
+ */
+void LocalSocket::close() {
+    if (handle >= 0) {
+        closeHandle(handle);
+        handle = -1;
+    }
+    buffer.clear();
+}
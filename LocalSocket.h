@@ -0,0 +1,143 @@
+/* *******************************************************
+ * Filename		:	LocalSocket.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	LocalSocket Class Header
+ * ******************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief Minimal Unix domain stream socket used by the detection daemon and its clients.
+  *
+  * Works with POSIX sockets and with AF_UNIX on Windows 10 and later. The object owns the
+  * socket handle and closes it on destruction, it can be moved but not copied.
+  */
+class LocalSocket {
+private:
+    intptr_t handle;        ///< Native socket handle, -1 when closed
+    std::string buffer;     ///< Bytes received but not consumed yet
+
+    /**
+     * @brief Receive more bytes into the buffer.
+     * @return False on end of stream or error.
+     */
+    bool fill();
+
+public:
+    /**
+     * @brief Constructor that creates a closed socket.
+     */
+    LocalSocket();
+
+    /**
+     * @brief Constructor that takes ownership of a native handle.
+     * @param nativeHandle The socket handle.
+     */
+    explicit LocalSocket(intptr_t nativeHandle);
+
+    /**
+     * @brief Destructor, closes the socket.
+     */
+    ~LocalSocket();
+
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+
+    /**
+     * @brief Create a listening socket bound to a path, a stale socket file is removed first.
+     * @param path The socket path.
+     * @param backlog Maximum number of pending connections.
+     * @return The listening socket.
+     * @throws std::runtime_error if the socket cannot be created or bound.
+     */
+    static LocalSocket listen(const std::string& path, int backlog);
+
+    /**
+     * @brief Connect to a listening socket.
+     * @param path The socket path.
+     * @return The connected socket.
+     * @throws std::runtime_error if the connection fails.
+     */
+    static LocalSocket connect(const std::string& path);
+
+    /**
+     * @brief Wait for the next connection on a listening socket.
+     * @return The connected socket, closed if accept failed.
+     */
+    LocalSocket accept();
+
+    /**
+     * @brief Read one line without its terminating newline.
+     * @param line Receives the line.
+     * @param maxLength Longest accepted line in bytes.
+     * @return False on end of stream before a full line or if the line is longer than maxLength.
+     */
+    bool readLine(std::string& line, size_t maxLength = 64 << 10);
+
+    /**
+     * @brief Read an exact number of bytes.
+     * @param data Receives the bytes, its capacity is reused.
+     * @param size Number of bytes to read.
+     * @return False on end of stream before all bytes arrived.
+     */
+    bool readExact(std::vector<unsigned char>& data, size_t size);
+
+    /**
+     * @brief Write all bytes.
+     * @param data Pointer to the bytes.
+     * @param size Number of bytes.
+     * @return False if the peer closed the connection.
+     */
+    bool writeAll(const char* data, size_t size);
+
+    /**
+     * @brief Write a string.
+     * @param data The string.
+     * @return False if the peer closed the connection.
+     */
+    bool writeAll(const std::string& data);
+
+    /**
+     * @brief Limit how long a read may wait for data.
+     * @param milliseconds The timeout, 0 waits forever.
+     */
+    void setReadTimeout(int milliseconds);
+
+    /**
+     * @brief Check whether received bytes are buffered that no read has consumed yet.
+     * @return True if the next read can start without waiting for the peer.
+     */
+    bool hasBufferedData() const;
+
+    /**
+     * @brief Receive and drop the bytes that are available, waiting for at least one.
+     * @return False on end of stream or error.
+     */
+    bool discard();
+
+    /**
+     * @brief Wait until at least one socket is readable, closed by the peer or failed.
+     * @param sockets The sockets to watch, none may be closed.
+     * @param readable Set to one flag per socket.
+     * @return False if waiting failed.
+     */
+    static bool waitReadable(const std::vector<const LocalSocket*>& sockets, std::vector<char>& readable);
+
+    /**
+     * @brief Check whether the socket is open.
+     * @return True if the socket holds a handle.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Close the socket.
+     */
+    void close();
+};
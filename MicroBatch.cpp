@@ -0,0 +1,216 @@
+/* *******************************************************
+ * Filename		:	MicroBatch.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	MicroBatch Class Source
+ * ******************************************************/
+
+#include "MicroBatch.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+#include "ParallelLoop.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Constructor that preallocates the atlas and all work buffers.
+ *
+ * Tiles are laid out on a square grid. The gutter covers the combined radius of the blur and the
+ * bilateral filter, so two images never influence each other. The Hough accumulator is sized for
+ * the largest tile within the engine's memory budget.
+ */
+MicroBatch::MicroBatch(cv::Size maxTile, int capacity) : maxTile(maxTile), capacity(capacity), gutter(8),
+    engine(LineDetection::defaultRho, LineDetection::defaultTheta, LineDetection::defaultHoughThreshold,
+        LineDetection::defaultMinLineLength, LineDetection::defaultMaxLineGap) {
+    if (maxTile.width <= 0 || maxTile.height <= 0 || capacity <= 0) {
+        throw std::invalid_argument("MicroBatch needs a positive tile size and capacity");
+    }
+
+    columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(capacity))));
+    const int rows = (capacity + columns - 1) / columns;
+    stride = cv::Size(maxTile.width + 2 * gutter, maxTile.height + 2 * gutter);
+
+    scratch.create(maxTile, CV_8UC1);
+    atlas = cv::Mat::zeros(rows * stride.height, columns * stride.width, CV_8UC1);
+    blurred.create(atlas.size(), CV_8UC1);
+    denoised.create(atlas.size(), CV_8UC1);
+    edges.create(atlas.size(), CV_8UC1);
+    response.create(atlas.size(), CV_32FC1);
+    images.reserve(capacity);
+    accumulator.reserve(engine.accumulatorCells(maxTile));
+}
+
+/**
+ * @brief Pack an image into the next free tile.
+ *
+ * The image is converted to grayscale in the scratch buffer and copied to the top left corner of
+ * its tile together with a reflected border of gutter pixels.
+ *
+ * @return bool False if the batch is full.
+ */
+bool MicroBatch::add(const cv::Mat& image) {
+    if (image.empty() || image.depth() != CV_8U) {
+        throw std::invalid_argument("MicroBatch accepts non-empty 8-bit images only");
+    }
+    if (image.cols > maxTile.width || image.rows > maxTile.height) {
+        throw std::invalid_argument("Image is larger than the MicroBatch tile size");
+    }
+    if (full()) {
+        return false;
+    }
+
+    cv::Mat gray = scratch(cv::Rect(0, 0, image.cols, image.rows));
+    switch (image.channels()) {
+    case 1: image.copyTo(gray); break;
+    case 3: cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY); break;
+    case 4: cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY); break;
+    default: throw std::invalid_argument("MicroBatch accepts 1, 3 or 4 channel images only");
+    }
+
+    const int index = static_cast<int>(images.size());
+    const cv::Point origin((index % columns) * stride.width, (index / columns) * stride.height);
+    cv::Mat tile = atlas(cv::Rect(origin, cv::Size(image.cols + 2 * gutter, image.rows + 2 * gutter)));
+    // The scratch ROI must not borrow pixels from the rest of the scratch buffer for its border
+    cv::copyMakeBorder(gray, tile, gutter, gutter, gutter, gutter, cv::BORDER_REFLECT_101 | cv::BORDER_ISOLATED);
+
+    images.push_back(cv::Rect(origin.x + gutter, origin.y + gutter, image.cols, image.rows));
+    return true;
+}
+
+/**
+ * @brief Detect lines and corners of every packed image.
+ *
+ * The filters, Canny and the corner response run once on the atlas. The Hough transform runs on
+ * the edges of each image in turn, in the shared accumulator and with its own voting parallelized,
+ * so its segments are already in image coordinates. Merging and corner selection then run per
+ * image on OpenCV's thread pool.
+ */
+void MicroBatch::process(std::vector<BatchFeatures>& results) {
+    results.assign(images.size(), BatchFeatures());
+    if (images.empty()) {
+        return;
+    }
+
+    cv::GaussianBlur(atlas, blurred, cv::Size(CommonProcesses::blurKernelSize, CommonProcesses::blurKernelSize), CommonProcesses::blurSigma);
+    cv::bilateralFilter(blurred, denoised, CommonProcesses::bilateralDiameter, CommonProcesses::bilateralSigma, CommonProcesses::bilateralSigma);
+    cv::Canny(denoised, edges, LineDetection::defaultThreshold, LineDetection::defaultThreshold * 3, 3);
+
+    if (CornerDetection::defaultUseHarrisDetector) {
+        cv::cornerHarris(denoised, response, CornerDetection::defaultBlockSize, 3, CornerDetection::defaultK);
+    }
+    else {
+        cv::cornerMinEigenVal(denoised, response, CornerDetection::defaultBlockSize, 3);
+    }
+
+    // The gutters are outside every image area, so reflected copies never vote
+    for (size_t i = 0; i < images.size(); ++i) {
+        engine.detectCompactHough(edges(images[i]), results[i].lines, accumulator);
+    }
+
+    ParallelLoop::run(cv::Range(0, static_cast<int>(images.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; ++i) {
+            LineDetection::mergeLines(results[i].lines);
+            selectCorners(images[i], results[i].corners);
+        }
+    });
+}
+
+/**
+ * @brief Select the corners of one image from the atlas response.
+ *
+ * Follows cv::goodFeaturesToTrack on the image area: responses below the quality level times the
+ * image maximum are dropped, the remaining local maxima away from the image border are sorted by
+ * strength and accepted greedily while they keep the minimum distance to the accepted ones.
+ */
+void MicroBatch::selectCorners(const cv::Rect& area, std::vector<cv::Point2f>& corners) const {
+    corners.clear();
+    const cv::Mat tile = response(area);
+    double maxValue = 0.0;
+    cv::minMaxLoc(tile, nullptr, &maxValue);
+    const float limit = static_cast<float>(maxValue * CornerDetection::defaultQualityLevel);
+
+    auto kept = [limit](float value) { return value > limit ? value : 0.0f; };
+    std::vector<std::pair<float, cv::Point>> candidates;
+    for (int y = 1; y < tile.rows - 1; ++y) {
+        const float* above = tile.ptr<float>(y - 1);
+        const float* row = tile.ptr<float>(y);
+        const float* below = tile.ptr<float>(y + 1);
+        for (int x = 1; x < tile.cols - 1; ++x) {
+            const float value = kept(row[x]);
+            if (value == 0.0f) {
+                continue;
+            }
+            bool peak = true;
+            for (int dx = -1; dx <= 1 && peak; ++dx) {
+                peak = value >= kept(above[x + dx]) && value >= kept(row[x + dx]) && value >= kept(below[x + dx]);
+            }
+            if (peak) {
+                candidates.push_back(std::make_pair(value, cv::Point(x, y)));
+            }
+        }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const std::pair<float, cv::Point>& a, const std::pair<float, cv::Point>& b) { return a.first > b.first; });
+
+    const double minDistanceSquared = CornerDetection::defaultMinDistance * CornerDetection::defaultMinDistance;
+    for (const std::pair<float, cv::Point>& candidate : candidates) {
+        if (static_cast<int>(corners.size()) >= CornerDetection::maxCorners) {
+            break;
+        }
+        const cv::Point2f point(static_cast<float>(candidate.second.x), static_cast<float>(candidate.second.y));
+        bool separated = true;
+        for (const cv::Point2f& corner : corners) {
+            const float dx = corner.x - point.x, dy = corner.y - point.y;
+            if (dx * dx + dy * dy < minDistanceSquared) {
+                separated = false;
+                break;
+            }
+        }
+        if (separated) {
+            corners.push_back(point);
+        }
+    }
+}
+
+/**
+ * @brief Remove all images, keeping the buffers for the next batch.
+ *
+ * The atlas is cleared so that the tiles of a smaller batch do not see stale pixels.
+ */
+void MicroBatch::clear() {
+    images.clear();
+    atlas.setTo(0);
+}
+
+/**
+ * @brief Get the number of packed images.
+ *
+ * @return size_t The image count.
+ */
+size_t MicroBatch::size() const {
+    return images.size();
+}
+
+/**
+ * @brief Check whether every tile is taken.
+ *
+ * @return bool True if no more images can be added.
+ */
+bool MicroBatch::full() const {
+    return static_cast<int>(images.size()) >= capacity;
+}
+
+/**
+ * @brief Get the memory held by the preallocated buffers.
+ *
+ * Includes the Hough accumulator. The edge mask and point list the compact engine builds for one
+ * tile at a time are not counted.
+ *
+ * @return size_t The number of bytes.
+ */
+size_t MicroBatch::memoryBytes() const {
+    return scratch.total() * scratch.elemSize() + (atlas.total() + blurred.total() + denoised.total() + edges.total())
+        + response.total() * response.elemSize() + accumulator.capacity() * sizeof(uint16_t);
+}
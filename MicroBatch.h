@@ -0,0 +1,110 @@
+/* *******************************************************
+ * Filename		:	MicroBatch.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	MicroBatch Class Header
+ * ******************************************************/
+
+#pragma once
+#include "LineSegmentEngine.h"
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+ /**
+  * @brief Features of one image of a batch, in the coordinates of that image.
+  */
+struct BatchFeatures {
+    std::vector<cv::Vec4i> lines;       ///< Merged line segments
+    std::vector<cv::Point2f> corners;   ///< Corners, strongest first
+};
+
+/**
+ * @brief The MicroBatch class.
+ *
+ * Packs small images into the tiles of one preallocated atlas and runs the blur, bilateral denoise,
+ * Canny and corner response passes once over the whole atlas instead of once per image. Every tile
+ * is surrounded by a gutter filled with the reflected border of its image, so the filters see the
+ * same neighbourhood as they would on the image alone. Lines are extracted per tile with the compact
+ * Hough engine into one accumulator preallocated for the largest tile, so votes of different images
+ * never mix and no accumulator is allocated per call as cv::HoughLinesP does. Lines are then merged
+ * and corners selected per tile with the default parameters of LineDetection and CornerDetection.
+ * Images are processed at their own resolution, without the rescale of the single image pipeline.
+ */
+class MicroBatch {
+private:
+    cv::Size maxTile;               ///< Largest image size a tile accepts
+    int capacity;                   ///< Number of tiles in the atlas
+    int gutter;                     ///< Reflected border around every tile in pixels
+    int columns;                    ///< Number of tile columns in the atlas
+    cv::Size stride;                ///< Distance between the origins of neighbouring tiles
+
+    cv::Mat scratch;                ///< Grayscale conversion buffer of one image
+    cv::Mat atlas;                  ///< Packed grayscale images with their gutters
+    cv::Mat blurred;                ///< Gaussian blurred atlas
+    cv::Mat denoised;               ///< Bilateral filtered atlas
+    cv::Mat edges;                  ///< Canny edges of the atlas
+    cv::Mat response;               ///< Corner response of the atlas
+    std::vector<cv::Rect> images;   ///< Area of every packed image in the atlas
+
+    LineSegmentEngine engine;       ///< Hough parameters and compact Hough engine
+    std::vector<uint16_t> accumulator;  ///< Hough votes, sized for the largest tile and reused by every tile
+
+    /**
+     * @brief Select the corners of one image from the atlas response.
+     *
+     * @param area Area of the image in the atlas.
+     * @param corners Output corners in image coordinates.
+     */
+    void selectCorners(const cv::Rect& area, std::vector<cv::Point2f>& corners) const;
+
+public:
+    /**
+     * @brief Constructor that preallocates the atlas and all work buffers.
+     *
+     * @param maxTile Largest image size the batch accepts.
+     * @param capacity Number of images per batch.
+     * @throws std::invalid_argument if the tile size or the capacity is not positive.
+     */
+    MicroBatch(cv::Size maxTile, int capacity);
+
+    /**
+     * @brief Pack an image into the next free tile.
+     *
+     * @param image 8-bit grayscale, BGR or BGRA image no larger than the tile size.
+     * @return False if the batch is full.
+     * @throws std::invalid_argument if the image is empty, not 8-bit or larger than the tile size.
+     */
+    bool add(const cv::Mat& image);
+
+    /**
+     * @brief Detect lines and corners of every packed image.
+     *
+     * @param results Output features, one entry per image in the order they were added.
+     */
+    void process(std::vector<BatchFeatures>& results);
+
+    /**
+     * @brief Remove all images, keeping the buffers for the next batch.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of packed images.
+     * @return The image count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check whether every tile is taken.
+     * @return True if no more images can be added.
+     */
+    bool full() const;
+
+    /**
+     * @brief Get the memory held by the preallocated buffers.
+     * @return The number of bytes.
+     */
+    size_t memoryBytes() const;
+};
@@ -0,0 +1,55 @@
+/* *******************************************************
+ * Filename		:	OverlayRenderer.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	OverlayRenderer Class Implementation
+ * ******************************************************/
+
+#include "OverlayRenderer.h"
+
+ /**
+  * @brief Render the requested layers in one pass.
+  *
+  * The base image is converted to BGR once, then the layers are drawn in order: lines, line
+  * endpoints and corners, so markers stay visible on top of thick lines.
+  *
+  * @return cv::Mat The rendered image.
+  */
+cv::Mat OverlayRenderer::render(const cv::Mat& base, int layers, const std::vector<cv::Vec4i>& lines, const std::vector<cv::Point2f>& corners) {
+    cv::Mat image;
+    if (base.empty()) {
+        return image;
+    }
+    if (base.channels() == 1) {
+        cv::cvtColor(base, image, cv::COLOR_GRAY2BGR);
+    }
+    else {
+        image = base.clone();
+    }
+
+    const cv::Scalar green(0, 255, 0);
+    const cv::Scalar blue(255, 0, 0);
+
+    if (layers & Lines) {
+        for (const cv::Vec4i& line : lines) {
+            cv::line(image, cv::Point(line[0], line[1]), cv::Point(line[2], line[3]), green, 5);
+        }
+    }
+    if (layers & LineEndpoints) {
+        for (const cv::Vec4i& line : lines) {
+            cv::circle(image, cv::Point(line[0], line[1]), 3, green, -1);
+            cv::circle(image, cv::Point(line[2], line[3]), 3, green, -1);
+        }
+    }
+    if (layers & Corners) {
+        for (const cv::Point2f& corner : corners) {
+            cv::circle(image, corner, 5, green, -1);
+        }
+    }
+    if (layers & CornerMarkers) {
+        for (const cv::Point2f& corner : corners) {
+            cv::circle(image, corner, 3, blue, -1);
+        }
+    }
+    return image;
+}
@@ -0,0 +1,76 @@
+/* *******************************************************
+ * Filename		:	OverlayRenderer.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	OverlayRenderer Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <mutex>
+#include <vector>
+
+ /**
+  * @brief Draws feature overlays on a grayscale working image.
+  *
+  * Rendering is kept out of analyzeFeatures(): the detectors only call it when an output image is
+  * requested. Any combination of layers is drawn in a single pass over one BGR copy of the base image.
+  */
+class OverlayRenderer {
+public:
+    /**
+     * @brief Overlay layers, combine them with a bitwise or.
+     */
+    enum Layer {
+        Lines = 1,              ///< Line segments, green, 5 px thick
+        Corners = 2,            ///< Corners, filled green circles with radius 5
+        LineEndpoints = 4,      ///< Line endpoints, filled green circles with radius 3
+        CornerMarkers = 8,      ///< Corners, filled blue circles with radius 3
+        Combined = Lines | LineEndpoints | CornerMarkers    ///< Lines and corners merged into one image
+    };
+
+    /**
+     * @brief Render the requested layers.
+     * @param base The 8-bit grayscale or BGR working image.
+     * @param layers Bitwise or of Layer values.
+     * @param lines Line segments in working coordinates.
+     * @param corners Corners in working coordinates.
+     * @return A new BGR image with the layers drawn, empty if the base image is empty.
+     */
+    static cv::Mat render(const cv::Mat& base, int layers, const std::vector<cv::Vec4i>& lines, const std::vector<cv::Point2f>& corners);
+};
+
+/**
+ * @brief Mutex guarding the lazily rendered images of a detector.
+ *
+ * A std::mutex member would make the detectors neither copyable nor movable. A copy of this class
+ * is a fresh, unlocked mutex, so the detectors keep their implicit copy and move members.
+ */
+class RenderMutex {
+private:
+    std::mutex mutex;   ///< The wrapped mutex
+
+public:
+    RenderMutex() = default;
+
+    /**
+     * @brief Copy constructor, creates a fresh mutex.
+     */
+    RenderMutex(const RenderMutex&) {}
+
+    /**
+     * @brief Copy assignment, keeps this object's mutex.
+     * @return Reference to this object.
+     */
+    RenderMutex& operator=(const RenderMutex&) { return *this; }
+
+    /**
+     * @brief Lock the mutex.
+     */
+    void lock() { mutex.lock(); }
+
+    /**
+     * @brief Unlock the mutex.
+     */
+    void unlock() { mutex.unlock(); }
+};
@@ -0,0 +1,47 @@
+/* *******************************************************
+ * Filename		:	ParallelLoop.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	ParallelLoop Helper Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <functional>
+#include <utility>
+
+ /**
+  * @brief Adapter that runs a callable as a cv::ParallelLoopBody.
+  *
+  * OpenCV 3.2 has no std::function overload of cv::parallel_for_, so loop bodies are wrapped here
+  * and scheduled on OpenCV's own thread pool.
+  */
+class ParallelLoop : public cv::ParallelLoopBody {
+private:
+    std::function<void(const cv::Range&)> body;    ///< Work executed for every sub-range
+
+public:
+    /**
+     * @brief Constructor that stores the loop body.
+     * @param loopBody Callable invoked with each sub-range of the iteration space.
+     */
+    explicit ParallelLoop(std::function<void(const cv::Range&)> loopBody) : body(std::move(loopBody)) {}
+
+    /**
+     * @brief Execute the loop body for one sub-range.
+     * @param range The sub-range assigned to the calling thread.
+     */
+    void operator()(const cv::Range& range) const override {
+        body(range);
+    }
+
+    /**
+     * @brief Split a range into stripes and run the body on OpenCV's thread pool.
+     * @param range The full iteration space.
+     * @param loopBody Callable invoked with each sub-range.
+     * @param nstripes Approximate number of stripes, -1 lets OpenCV decide.
+     */
+    static void run(const cv::Range& range, std::function<void(const cv::Range&)> loopBody, double nstripes = -1.) {
+        cv::parallel_for_(range, ParallelLoop(std::move(loopBody)), nstripes);
+    }
+};
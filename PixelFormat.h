@@ -0,0 +1,52 @@
+/* *******************************************************
+ * Filename		:	PixelFormat.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	Pixel Format Traits Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <stdexcept>
+
+ /**
+  * @brief 8-bit pixel formats the preprocessing pipeline is specialized for.
+  */
+enum class PixelFormat {
+    Gray8,      ///< One 8-bit luminance channel
+    BGR8        ///< Three 8-bit channels in OpenCV's blue, green, red order
+};
+
+/**
+ * @brief Compile-time properties of a pixel format.
+ */
+template<PixelFormat Format>
+struct PixelTraits;
+
+template<>
+struct PixelTraits<PixelFormat::Gray8> {
+    static constexpr int channels = 1;  ///< Number of interleaved channels
+};
+
+template<>
+struct PixelTraits<PixelFormat::BGR8> {
+    static constexpr int channels = 3;  ///< Number of interleaved channels
+};
+
+/**
+ * @brief Determine the pixel format of an image, the single runtime dispatch point of the pipeline.
+ * @param image The image.
+ * @return The pixel format.
+ * @throws std::runtime_error if the image is not 8-bit with 1 or 3 channels.
+ */
+inline PixelFormat pixelFormatOf(const cv::Mat& image) {
+    if (image.depth() == CV_8U) {
+        switch (image.channels()) {
+        case 1:
+            return PixelFormat::Gray8;
+        case 3:
+            return PixelFormat::BGR8;
+        }
+    }
+    throw std::runtime_error("Unsupported pixel format, expected 8-bit images with 1 or 3 channels");
+}
@@ -0,0 +1,230 @@
+/* *******************************************************
+ * Filename		:	PointIndex.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	PointIndex Class Implementation
+ * ******************************************************/
+
+#include "PointIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+ /**
+  * @brief Constructor that creates an empty index.
+  */
+PointIndex::PointIndex() : origin(0.0f, 0.0f), cellSize(1.0f), cols(0), rows(0) {}
+
+/**
+ * @brief Column of the cell containing an x coordinate, clamped to the grid.
+ *
+ * @return int The column.
+ */
+int PointIndex::cellColumn(float x) const {
+    const int column = static_cast<int>(std::floor((x - origin.x) / cellSize));
+    return std::min(std::max(column, 0), cols - 1);
+}
+
+/**
+ * @brief Row of the cell containing a y coordinate, clamped to the grid.
+ *
+ * @return int The row.
+ */
+int PointIndex::cellRow(float y) const {
+    const int row = static_cast<int>(std::floor((y - origin.y) / cellSize));
+    return std::min(std::max(row, 0), rows - 1);
+}
+
+/**
+ * @brief Build the index with a counting sort of the points by cell.
+ *
+ * The automatic cell size targets four points per cell over the bounding box. Degenerate boxes are
+ * treated as at least one pixel wide so that collinear points do not produce a huge grid.
+ *
+ * @throws std::invalid_argument if the cell size is negative.
+ */
+void PointIndex::build(const std::vector<cv::Point2f>& input, float cell) {
+    if (cell < 0.0f) {
+        throw std::invalid_argument("Cell size must not be negative");
+    }
+    points.clear();
+    ids.clear();
+    cellStart.clear();
+    cols = 0;
+    rows = 0;
+    if (input.empty()) {
+        return;
+    }
+
+    float minX = input[0].x, minY = input[0].y, maxX = input[0].x, maxY = input[0].y;
+    for (const cv::Point2f& point : input) {
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+    const double width = std::max(1.0, static_cast<double>(maxX) - minX);
+    const double height = std::max(1.0, static_cast<double>(maxY) - minY);
+
+    origin = cv::Point2f(minX, minY);
+    cellSize = cell > 0.0f ? cell : static_cast<float>(std::sqrt(width * height * 4.0 / input.size()));
+    cols = static_cast<int>(width / cellSize) + 1;
+    rows = static_cast<int>(height / cellSize) + 1;
+
+    // Counting sort: histogram, prefix sum, scatter.
+    std::vector<int> cellOf(input.size());
+    cellStart.assign(static_cast<size_t>(cols) * rows + 1, 0);
+    for (size_t i = 0; i < input.size(); ++i) {
+        cellOf[i] = cellRow(input[i].y) * cols + cellColumn(input[i].x);
+        ++cellStart[cellOf[i] + 1];
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+    points.resize(input.size());
+    ids.resize(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        const int slot = next[cellOf[i]]++;
+        points[slot] = input[i];
+        ids[slot] = static_cast<int>(i);
+    }
+}
+
+/**
+ * @brief Get the number of indexed points.
+ *
+ * @return size_t The number of points.
+ */
+size_t PointIndex::size() const {
+    return points.size();
+}
+
+/**
+ * @brief Get the number of bytes held by the index.
+ *
+ * @return size_t The memory in bytes.
+ */
+size_t PointIndex::memoryBytes() const {
+    return points.capacity() * sizeof(cv::Point2f) + (ids.capacity() + cellStart.capacity()) * sizeof(int);
+}
+
+/**
+ * @brief Find the points inside a box, borders included.
+ */
+void PointIndex::queryBox(const cv::Rect2f& box, std::vector<int>& result) const {
+    result.clear();
+    if (points.empty() || box.width < 0.0f || box.height < 0.0f) {
+        return;
+    }
+
+    const float right = box.x + box.width;
+    const float bottom = box.y + box.height;
+    const int c0 = cellColumn(box.x), c1 = cellColumn(right);
+    const int r0 = cellRow(box.y), r1 = cellRow(bottom);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cellIndex = r * cols + c;
+            for (int i = cellStart[cellIndex]; i < cellStart[cellIndex + 1]; ++i) {
+                const cv::Point2f& p = points[i];
+                if (p.x >= box.x && p.x <= right && p.y >= box.y && p.y <= bottom) {
+                    result.push_back(ids[i]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find the points within a distance of a query point.
+ */
+void PointIndex::queryRadius(const cv::Point2f& center, float radius, std::vector<int>& result) const {
+    result.clear();
+    if (points.empty() || radius < 0.0f) {
+        return;
+    }
+
+    const float radiusSquared = radius * radius;
+    const int c0 = cellColumn(center.x - radius), c1 = cellColumn(center.x + radius);
+    const int r0 = cellRow(center.y - radius), r1 = cellRow(center.y + radius);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cellIndex = r * cols + c;
+            for (int i = cellStart[cellIndex]; i < cellStart[cellIndex + 1]; ++i) {
+                const float dx = points[i].x - center.x;
+                const float dy = points[i].y - center.y;
+                if (dx * dx + dy * dy <= radiusSquared) {
+                    result.push_back(ids[i]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find the k points nearest to a query point.
+ *
+ * Visits square rings of cells around the query's cell. Every point in ring r + 1 or further is at
+ * least r cells away, so the search stops as soon as the k-th best distance is within that bound.
+ * Queries outside the grid start at the nearest border cell, which only makes the bound looser.
+ */
+void PointIndex::nearest(const cv::Point2f& query, int k, std::vector<int>& result) const {
+    result.clear();
+    if (points.empty() || k <= 0) {
+        return;
+    }
+
+    // Max-heap of the best candidates so far, (squared distance, ordered index).
+    std::priority_queue<std::pair<float, int>> best;
+    const int qc = cellColumn(query.x);
+    const int qr = cellRow(query.y);
+    const int maxRing = std::max(cols, rows);
+
+    auto visit = [&](int r, int c) {
+        if (r < 0 || r >= rows || c < 0 || c >= cols) {
+            return;
+        }
+        const int cellIndex = r * cols + c;
+        for (int i = cellStart[cellIndex]; i < cellStart[cellIndex + 1]; ++i) {
+            const float dx = points[i].x - query.x;
+            const float dy = points[i].y - query.y;
+            const float distance = dx * dx + dy * dy;
+            if (static_cast<int>(best.size()) < k) {
+                best.emplace(distance, i);
+            }
+            else if (distance < best.top().first) {
+                best.pop();
+                best.emplace(distance, i);
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        if (ring == 0) {
+            visit(qr, qc);
+        }
+        else {
+            for (int c = qc - ring; c <= qc + ring; ++c) {
+                visit(qr - ring, c);
+                visit(qr + ring, c);
+            }
+            for (int r = qr - ring + 1; r <= qr + ring - 1; ++r) {
+                visit(r, qc - ring);
+                visit(r, qc + ring);
+            }
+        }
+        const float bound = ring * cellSize;
+        if (static_cast<int>(best.size()) == k && best.top().first <= bound * bound) {
+            break;
+        }
+    }
+
+    result.resize(best.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = ids[best.top().second];
+        best.pop();
+    }
+}
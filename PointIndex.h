@@ -0,0 +1,93 @@
+/* *******************************************************
+ * Filename		:	PointIndex.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	PointIndex Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <cstddef>
+
+ /**
+  * @brief Uniform grid over a static set of points.
+  *
+  * The points are bucketed by a counting sort into a compact cell-ordered array with one offset per
+  * cell, so the index costs two ints and a point per entry plus one int per cell, and a query only
+  * touches the cells it overlaps. The cell size defaults to about four points per cell. Results are
+  * indices into the vector the index was built from.
+  */
+class PointIndex {
+private:
+    std::vector<cv::Point2f> points;    ///< Points ordered by cell
+    std::vector<int> ids;               ///< Original index of every ordered point
+    std::vector<int> cellStart;         ///< First ordered point of every cell, plus one end entry
+    cv::Point2f origin;                 ///< Corner of the grid with the smallest coordinates
+    float cellSize;                     ///< Side length of a cell
+    int cols;                           ///< Number of cell columns
+    int rows;                           ///< Number of cell rows
+
+    /**
+     * @brief Column of the cell containing an x coordinate, clamped to the grid.
+     * @param x The x coordinate.
+     * @return The column.
+     */
+    int cellColumn(float x) const;
+
+    /**
+     * @brief Row of the cell containing a y coordinate, clamped to the grid.
+     * @param y The y coordinate.
+     * @return The row.
+     */
+    int cellRow(float y) const;
+
+public:
+    /**
+     * @brief Constructor that creates an empty index.
+     */
+    PointIndex();
+
+    /**
+     * @brief Build the index, replacing the previous content.
+     * @param input The points.
+     * @param cell Cell side length, 0 chooses one from the point density.
+     * @throws std::invalid_argument if the cell size is negative.
+     */
+    void build(const std::vector<cv::Point2f>& input, float cell = 0.0f);
+
+    /**
+     * @brief Get the number of indexed points.
+     * @return The number of points.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of bytes held by the index.
+     * @return The memory in bytes.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Find the points inside a box, borders included.
+     * @param box The query box.
+     * @param result Cleared and set to the indices of the points found.
+     */
+    void queryBox(const cv::Rect2f& box, std::vector<int>& result) const;
+
+    /**
+     * @brief Find the points within a distance of a query point.
+     * @param center The query point.
+     * @param radius The maximum distance.
+     * @param result Cleared and set to the indices of the points found.
+     */
+    void queryRadius(const cv::Point2f& center, float radius, std::vector<int>& result) const;
+
+    /**
+     * @brief Find the k points nearest to a query point.
+     * @param query The query point.
+     * @param k Number of neighbours.
+     * @param result Cleared and set to the indices of at most k points, nearest first.
+     */
+    void nearest(const cv::Point2f& query, int k, std::vector<int>& result) const;
+};
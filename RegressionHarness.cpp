@@ -0,0 +1,240 @@
+/* *******************************************************
+ * Filename		:	RegressionHarness.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	RegressionHarness Class Implementation
+ * ******************************************************/
+
+#include "RegressionHarness.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+#include "Benchmark.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+
+ /**
+  * @brief Constructor that takes the acceptance criteria.
+  *
+  * @throws std::invalid_argument if a value is out of range.
+  */
+RegressionHarness::RegressionHarness(double tolerance, double minAccuracy, int repetitions)
+    : tolerance(tolerance), minAccuracy(minAccuracy), repetitions(repetitions) {
+    if (tolerance <= 0.0) {
+        throw std::invalid_argument("Tolerance must be positive");
+    }
+    if (minAccuracy < 0.0 || minAccuracy > 1.0) {
+        throw std::invalid_argument("Minimum accuracy must be in [0, 1]");
+    }
+    if (repetitions <= 0) {
+        throw std::invalid_argument("Repetitions must be positive");
+    }
+}
+
+/**
+ * @brief Add one image to the corpus.
+ */
+void RegressionHarness::addCase(const std::string& image, const std::string& linesGolden, const std::string& cornersGolden) {
+    cases.push_back({ image, linesGolden == "-" ? "" : linesGolden, cornersGolden == "-" ? "" : cornersGolden });
+}
+
+/**
+ * @brief Add the images of a manifest.
+ *
+ * @throws std::runtime_error if the manifest cannot be opened or a line is incomplete.
+ */
+void RegressionHarness::loadManifest(const std::string& manifest) {
+    std::ifstream inFile(manifest);
+    if (!inFile.is_open()) {
+        throw std::runtime_error("Could not open the manifest: " + manifest);
+    }
+
+    std::string line;
+    while (std::getline(inFile, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string image, linesGolden, cornersGolden;
+        if (!(fields >> image)) {
+            continue;
+        }
+        if (!(fields >> linesGolden >> cornersGolden)) {
+            throw std::runtime_error("Manifest line needs an image and two golden files: " + line);
+        }
+        addCase(image, linesGolden, cornersGolden);
+    }
+}
+
+/**
+ * @brief Get the pipeline modes known to the harness.
+ *
+ * @return The modes, "default" is the configuration main() uses to write the golden files.
+ */
+const std::vector<RegressionMode>& RegressionHarness::modes() {
+    static const std::vector<RegressionMode> all = {
+        { "default", LineEngine::OpenCVHough, DenoiseMode::Bilateral, false, 0.0 },
+        { "compact-hough", LineEngine::CompactHough, DenoiseMode::Bilateral, false, 0.0 },
+        { "lsd", LineEngine::SegmentDetector, DenoiseMode::Bilateral, false, 0.0 },
+        { "fast-guided", LineEngine::OpenCVHough, DenoiseMode::FastGuided, false, 0.0 },
+        { "lean", LineEngine::OpenCVHough, DenoiseMode::Bilateral, true, 0.0 },
+        { "budget", LineEngine::OpenCVHough, DenoiseMode::Bilateral, false, 50.0 }
+    };
+    return all;
+}
+
+/**
+ * @brief Read a feature file with one "x,y" pair per line.
+ *
+ * @throws std::runtime_error if the file cannot be opened or a line cannot be parsed.
+ */
+std::vector<cv::Point> RegressionHarness::readFeatureFile(const std::string& filename) {
+    std::ifstream inFile(filename);
+    if (!inFile.is_open()) {
+        throw std::runtime_error("Could not open the golden file: " + filename);
+    }
+
+    std::vector<cv::Point> points;
+    std::string line;
+    while (std::getline(inFile, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream fields(line);
+        cv::Point point;
+        char comma = 0;
+        if (!(fields >> point.x >> comma >> point.y) || comma != ',') {
+            throw std::runtime_error("Malformed line in golden file " + filename + ": " + line);
+        }
+        points.push_back(point);
+    }
+    return points;
+}
+
+/**
+ * @brief Pair consecutive endpoints into segments.
+ *
+ * @return std::vector<cv::Vec4i> The segments, a trailing unpaired endpoint is dropped.
+ */
+std::vector<cv::Vec4i> RegressionHarness::toSegments(const std::vector<cv::Point>& endpoints) {
+    std::vector<cv::Vec4i> segments;
+    segments.reserve(endpoints.size() / 2);
+    for (size_t i = 0; i + 1 < endpoints.size(); i += 2) {
+        segments.push_back(cv::Vec4i(endpoints[i].x, endpoints[i].y, endpoints[i + 1].x, endpoints[i + 1].y));
+    }
+    return segments;
+}
+
+/**
+ * @brief Run every image through the selected modes and write the report.
+ *
+ * The image is decoded once per case and the detectors are built from the decoded image, so the
+ * timings cover analyzeFeatures() only. Budget mode reports features in original-image coordinates,
+ * they are scaled back to the fixed 800x600 working resolution the golden files were written at.
+ *
+ * @throws std::invalid_argument if a mode name is unknown.
+ */
+bool RegressionHarness::run(const std::vector<std::string>& modeNames, std::ostream& os) const {
+    std::vector<RegressionMode> selected;
+    for (const std::string& name : modeNames) {
+        const std::vector<RegressionMode>& all = modes();
+        auto found = std::find_if(all.begin(), all.end(), [&name](const RegressionMode& mode) { return mode.name == name; });
+        if (found == all.end()) {
+            throw std::invalid_argument("Unknown regression mode: " + name);
+        }
+        selected.push_back(*found);
+    }
+    if (selected.empty()) {
+        selected = modes();
+    }
+
+    bool allPassed = true;
+    os << std::left << std::setw(24) << "Image" << std::setw(15) << "Mode" << std::setw(11) << "Time(ms)" << std::setw(13) << "Memory(KiB)"
+        << std::setw(12) << "LineRecall" << std::setw(10) << "LinePrec" << std::setw(11) << "CornerRep" << std::setw(11) << "LocErr(px)" << "Result\n";
+
+    for (const Case& testCase : cases) {
+        const cv::Mat image = cv::imread(testCase.image, CommonProcesses::imageReadFlags);
+        if (image.empty()) {
+            throw std::runtime_error("Could not read the regression image: " + testCase.image);
+        }
+        const bool checkLines = !testCase.linesGolden.empty();
+        const bool checkCorners = !testCase.cornersGolden.empty();
+        const std::vector<cv::Vec4i> goldenLines = checkLines ? toSegments(readFeatureFile(testCase.linesGolden)) : std::vector<cv::Vec4i>();
+        const std::vector<cv::Point> goldenCorners = checkCorners ? readFeatureFile(testCase.cornersGolden) : std::vector<cv::Point>();
+
+        for (const RegressionMode& mode : selected) {
+            double totalMs = 0.0;
+            size_t memoryBytes = 0;
+            std::vector<cv::Point> lineEndpoints;
+            std::vector<cv::Point> corners;
+
+            for (int run = 0; run < repetitions; ++run) {
+                LineDetection lineDetection(image);
+                CornerDetection cornerDetection(image);
+                Detection* detectors[] = { &lineDetection, &cornerDetection };
+                for (Detection* detection : detectors) {
+                    detection->setDenoiseMode(mode.denoiseMode);
+                    detection->setLeanMode(mode.lean);
+                    detection->setLatencyBudget(mode.budgetMs);
+                    if (mode.budgetMs > 0.0) {
+                        detection->calibrateCostModel();
+                    }
+                }
+                lineDetection.setLineEngine(mode.lineEngine);
+
+                const double start = Benchmark::nowMs();
+                if (checkLines) {
+                    lineDetection.analyzeFeatures();
+                }
+                if (checkCorners) {
+                    cornerDetection.analyzeFeatures();
+                }
+                totalMs += Benchmark::nowMs() - start;
+                memoryBytes = (checkLines ? lineDetection.memoryFootprint() : 0) + (checkCorners ? cornerDetection.memoryFootprint() : 0);
+
+                if (run + 1 == repetitions) {
+                    // Scale budget-mode coordinates back to the golden working resolution.
+                    const cv::Size original = image.size();
+                    const double sx = mode.budgetMs > 0.0 ? 800.0 / original.width : 1.0;
+                    const double sy = mode.budgetMs > 0.0 ? 600.0 / original.height : 1.0;
+                    const std::pair<std::vector<cv::Point>*, const Detection*> outputs[] = {
+                        { &lineEndpoints, &lineDetection }, { &corners, &cornerDetection } };
+                    for (const auto& output : outputs) {
+                        for (const std::pair<int, int>& feature : output.second->getanalyzeFeatures()) {
+                            output.first->push_back(cv::Point(cvRound(feature.first * sx), cvRound(feature.second * sy)));
+                        }
+                    }
+                }
+            }
+
+            bool passed = true;
+            os << std::setw(24) << testCase.image << std::setw(15) << mode.name << std::fixed << std::setprecision(2)
+                << std::setw(11) << totalMs / repetitions << std::setw(13) << memoryBytes / 1024;
+            if (checkLines) {
+                const std::vector<cv::Vec4i> lines = toSegments(lineEndpoints);
+                const double recall = Benchmark::segmentOverlap(goldenLines, lines, tolerance);
+                const double precision = Benchmark::segmentOverlap(lines, goldenLines, tolerance);
+                passed = passed && recall >= minAccuracy && precision >= minAccuracy;
+                os << std::setw(12) << recall << std::setw(10) << precision;
+            }
+            else {
+                os << std::setw(12) << "-" << std::setw(10) << "-";
+            }
+            if (checkCorners) {
+                double meanError = 0.0;
+                const double repeatability = Benchmark::cornerRepeatability(goldenCorners, corners, tolerance, meanError);
+                passed = passed && repeatability >= minAccuracy;
+                os << std::setw(11) << repeatability << std::setw(11) << meanError;
+            }
+            else {
+                os << std::setw(11) << "-" << std::setw(11) << "-";
+            }
+            os << (passed ? "PASS" : "FAIL") << "\n";
+            allPassed = allPassed && passed;
+        }
+    }
+
+    os << "Tolerance " << tolerance << " px, minimum accuracy " << minAccuracy << ": " << (allPassed ? "PASS" : "FAIL") << std::endl;
+    return allPassed;
+}
@@ -0,0 +1,106 @@
+/* *******************************************************
+ * Filename		:	RegressionHarness.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	RegressionHarness Class Header
+ * ******************************************************/
+
+#pragma once
+#include "CommonProcesses.h"
+#include "LineSegmentEngine.h"
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief A pipeline configuration checked by the regression harness.
+  */
+struct RegressionMode {
+    std::string name;           ///< Name used on the command line and in the report
+    LineEngine lineEngine;      ///< Line segment back-end
+    DenoiseMode denoiseMode;    ///< Denoiser used by commonOperations()
+    bool lean;                  ///< Run the detectors in lean mode
+    double budgetMs;            ///< Latency budget, 0 keeps the fixed 800x600 resolution
+};
+
+/**
+ * @brief The RegressionHarness class.
+ *
+ * Runs a corpus of images through each pipeline mode and compares the features with golden feature
+ * files written by Detection::writeFeaturesToFile() in the default mode. Lines are scored by segment
+ * overlap in both directions (recall against the golden segments and precision of the new ones),
+ * corners by repeatability and mean localization error. Every row also reports the analysis time and
+ * the memory held by the detectors, so a speedup can be approved together with its accuracy cost.
+ */
+class RegressionHarness {
+private:
+    /**
+     * @brief One corpus image with its golden files, an empty path skips that detector.
+     */
+    struct Case {
+        std::string image;
+        std::string linesGolden;
+        std::string cornersGolden;
+    };
+
+    std::vector<Case> cases;        ///< The corpus
+    double tolerance;               ///< Matching tolerance in pixels
+    double minAccuracy;             ///< Minimum line overlap and corner repeatability for a row to pass
+    int repetitions;                ///< Timed runs per image and mode
+
+    /**
+     * @brief Read a feature file with one "x,y" pair per line.
+     * @param filename The feature file.
+     * @return The points in file order.
+     * @throws std::runtime_error if the file cannot be opened or a line cannot be parsed.
+     */
+    static std::vector<cv::Point> readFeatureFile(const std::string& filename);
+
+    /**
+     * @brief Pair consecutive endpoints into segments, the layout LineDetection writes.
+     * @param endpoints The endpoints.
+     * @return The segments.
+     */
+    static std::vector<cv::Vec4i> toSegments(const std::vector<cv::Point>& endpoints);
+
+public:
+    /**
+     * @brief Constructor that takes the acceptance criteria.
+     * @param tolerance Matching tolerance in pixels.
+     * @param minAccuracy Minimum line overlap and corner repeatability in [0, 1].
+     * @param repetitions Timed runs per image and mode.
+     * @throws std::invalid_argument if a value is out of range.
+     */
+    RegressionHarness(double tolerance, double minAccuracy, int repetitions);
+
+    /**
+     * @brief Add one image to the corpus.
+     * @param image The image path.
+     * @param linesGolden Golden line feature file, empty or "-" to skip the lines.
+     * @param cornersGolden Golden corner feature file, empty or "-" to skip the corners.
+     */
+    void addCase(const std::string& image, const std::string& linesGolden, const std::string& cornersGolden);
+
+    /**
+     * @brief Add the images of a manifest with "<image> <linesGolden> <cornersGolden>" per line, '#' starts a comment.
+     * @param manifest The manifest file.
+     * @throws std::runtime_error if the manifest cannot be opened or a line is incomplete.
+     */
+    void loadManifest(const std::string& manifest);
+
+    /**
+     * @brief Get the pipeline modes known to the harness.
+     * @return The modes, the first one produced the golden files.
+     */
+    static const std::vector<RegressionMode>& modes();
+
+    /**
+     * @brief Run every image through the selected modes and write the report.
+     * @param modeNames Names of the modes to be run, empty runs all of them.
+     * @param os The stream the report is written to.
+     * @return True if every row meets the acceptance criteria.
+     * @throws std::invalid_argument if a mode name is unknown.
+     */
+    bool run(const std::vector<std::string>& modeNames, std::ostream& os) const;
+};
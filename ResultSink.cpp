@@ -0,0 +1,380 @@
+/* *******************************************************
+ * Filename		:	ResultSink.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	ResultSink Class Implementation
+ * ******************************************************/
+
+#include "ResultSink.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Buffer size at which the writer hands its block to the stream.
+     */
+    const size_t writeBlockBytes = 64 * 1024;
+
+    /**
+     * @brief Append a number with a fixed number of decimals.
+     * @param value The number.
+     * @param buffer The output buffer.
+     */
+    void appendNumber(double value, std::string& buffer) {
+        char text[32];
+        const int length = std::snprintf(text, sizeof(text), "%.2f", value);
+        buffer.append(text, length > 0 ? static_cast<size_t>(length) : 0);
+    }
+}
+
+ /**
+  * @brief Constructor that starts the writer thread.
+  *
+  * The CSV header is part of the first block the writer emits.
+  *
+  * @throws std::invalid_argument if the capacity is 0.
+  */
+ResultSink::ResultSink(std::ostream& os, SinkFormat format, SinkVerbosity verbosity, size_t capacity)
+    : os(os), format(format), verbosity(verbosity), capacity(capacity), closing(false) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Result sink capacity must be positive");
+    }
+    writer = std::thread(&ResultSink::writerLoop, this);
+}
+
+/**
+ * @brief Destructor that writes the remaining records.
+ */
+ResultSink::~ResultSink() {
+    close();
+}
+
+/**
+ * @brief Queue the results of one image.
+ *
+ * Only the feature vectors are copied here, formatting happens on the writer thread.
+ *
+ * @throws std::logic_error if the sink is closed.
+ */
+void ResultSink::submit(const std::string& image, const LineDetection* lines, const CornerDetection* corners) {
+    Record record;
+    record.image = image;
+    record.hasLines = lines != nullptr;
+    record.hasCorners = corners != nullptr;
+    // Each detector reports its own analysis, the preprocessing shared by both is reported once
+    record.preprocessMs = lines ? lines->getProcessingReport().preprocessMs : (corners ? corners->getProcessingReport().preprocessMs : 0.0);
+    record.lineMs = lines ? lines->getProcessingReport().detectMs : 0.0;
+    record.cornerMs = corners ? corners->getProcessingReport().detectMs : 0.0;
+    record.lineCount = lines ? lines->getLines().size() : 0;
+    record.cornerCount = corners ? corners->getCorners().size() : 0;
+    if (verbosity != SinkVerbosity::Summary) {
+        if (lines) {
+            record.lineEndpoints = lines->getanalyzeFeatures();
+        }
+        if (corners) {
+            record.corners = corners->getanalyzeFeatures();
+        }
+    }
+    enqueue(std::move(record));
+}
+
+/**
+ * @brief Queue an error record for an image that could not be processed.
+ *
+ * The record keeps the image name and the message, it has neither lines nor corners.
+ *
+ * @throws std::logic_error if the sink is closed.
+ */
+void ResultSink::submitError(const std::string& image, const std::string& message) {
+    Record record;
+    record.image = image;
+    record.error = message;
+    record.hasLines = false;
+    record.hasCorners = false;
+    record.preprocessMs = 0.0;
+    record.lineMs = 0.0;
+    record.cornerMs = 0.0;
+    record.lineCount = 0;
+    record.cornerCount = 0;
+    enqueue(std::move(record));
+}
+
+/**
+ * @brief Queue a record, waiting while the queue is full.
+ *
+ * @throws std::logic_error if the sink is closed.
+ */
+void ResultSink::enqueue(Record&& record) {
+    std::unique_lock<std::mutex> lock(mutex);
+    space.wait(lock, [this]() { return closing || queue.size() < capacity; });
+    if (closing) {
+        throw std::logic_error("Result sink is closed");
+    }
+    queue.push_back(std::move(record));
+    lock.unlock();
+    ready.notify_one();
+}
+
+/**
+ * @brief Write the remaining records, flush the stream and stop the writer thread.
+ */
+void ResultSink::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) {
+            return;
+        }
+        closing = true;
+    }
+    ready.notify_all();
+    space.notify_all();
+    writer.join();
+}
+
+/**
+ * @brief Main loop of the writer thread.
+ *
+ * Takes every queued record at once, formats them outside the lock and writes the buffer only
+ * when a block is full, the queue runs dry or the sink closes.
+ */
+void ResultSink::writerLoop() {
+    std::string buffer;
+    buffer.reserve(writeBlockBytes * 2);
+    if (format == SinkFormat::CSV) {
+        buffer += "image,preprocess_ms,line_count,line_ms,corner_count,corner_ms";
+        if (verbosity != SinkVerbosity::Summary) {
+            buffer += ",lines,corners";
+        }
+        buffer += ",error\n";
+    }
+
+    std::deque<Record> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return closing || !queue.empty(); });
+            if (queue.empty() && closing) {
+                break;
+            }
+            batch.swap(queue);
+        }
+        space.notify_all();
+
+        for (const Record& record : batch) {
+            formatRecord(record, buffer);
+            if (buffer.size() >= writeBlockBytes) {
+                os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        batch.clear();
+
+        // Nothing else is waiting, hand over what was formatted so far.
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle = queue.empty();
+        }
+        if (idle && !buffer.empty()) {
+            os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            os.flush();
+            buffer.clear();
+        }
+    }
+
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    os.flush();
+}
+
+/**
+ * @brief Append one formatted record to a buffer.
+ *
+ * NDJSON: {"image":...,"preprocess_ms":t,"lines":{"count":n,"ms":t,"segments":[[x1,y1,x2,y2],...]},
+ * "corners":{"count":n,"ms":t,"points":[[x,y],...]}} with [x1,y1,x2,y2,length,angle] segments in
+ * detailed mode, or {"image":...,"error":...} for an image that failed. The detector times exclude
+ * the preprocessing. CSV: the preprocessing time, the counts and times, then the segments as
+ * "x1 y1 x2 y2" and the corners as "x y", separated by ';', and last the error, empty for a
+ * successful image.
+ */
+void ResultSink::formatRecord(const Record& record, std::string& buffer) const {
+    const bool withFeatures = verbosity != SinkVerbosity::Summary;
+    const bool detailed = verbosity == SinkVerbosity::Detailed;
+    const size_t lineCount = record.lineCount;
+    const size_t cornerCount = record.cornerCount;
+
+    if (format == SinkFormat::CSV) {
+        appendCsvField(record.image, buffer);
+        buffer += ',';
+        if (record.hasLines || record.hasCorners) {
+            appendNumber(record.preprocessMs, buffer);
+        }
+        buffer += ',';
+        buffer += record.hasLines ? std::to_string(lineCount) : "";
+        buffer += ',';
+        if (record.hasLines) {
+            appendNumber(record.lineMs, buffer);
+        }
+        buffer += ',';
+        buffer += record.hasCorners ? std::to_string(cornerCount) : "";
+        buffer += ',';
+        if (record.hasCorners) {
+            appendNumber(record.cornerMs, buffer);
+        }
+        if (withFeatures) {
+            buffer += ',';
+            for (size_t i = 0; i < record.lineEndpoints.size() / 2; ++i) {
+                const std::pair<int, int>& a = record.lineEndpoints[2 * i];
+                const std::pair<int, int>& b = record.lineEndpoints[2 * i + 1];
+                buffer += (i ? ";" : "") + std::to_string(a.first) + ' ' + std::to_string(a.second) + ' ' +
+                    std::to_string(b.first) + ' ' + std::to_string(b.second);
+                if (detailed) {
+                    buffer += ' ';
+                    appendNumber(std::hypot(b.first - a.first, b.second - a.second), buffer);
+                    buffer += ' ';
+                    appendNumber(std::atan2(b.second - a.second, b.first - a.first) * 180.0 / CV_PI, buffer);
+                }
+            }
+            buffer += ',';
+            for (size_t i = 0; i < record.corners.size(); ++i) {
+                buffer += (i ? ";" : "") + std::to_string(record.corners[i].first) + ' ' + std::to_string(record.corners[i].second);
+            }
+        }
+        buffer += ',';
+        if (!record.error.empty()) {
+            appendCsvField(record.error, buffer);
+        }
+        buffer += '\n';
+        return;
+    }
+
+    buffer += "{\"image\":";
+    appendJsonString(record.image, buffer);
+    if (!record.error.empty()) {
+        buffer += ",\"error\":";
+        appendJsonString(record.error, buffer);
+    }
+    if (record.hasLines || record.hasCorners) {
+        buffer += ",\"preprocess_ms\":";
+        appendNumber(record.preprocessMs, buffer);
+    }
+    if (record.hasLines) {
+        buffer += ",\"lines\":{\"count\":" + std::to_string(lineCount) + ",\"ms\":";
+        appendNumber(record.lineMs, buffer);
+        if (withFeatures) {
+            buffer += ",\"segments\":[";
+            for (size_t i = 0; i < record.lineEndpoints.size() / 2; ++i) {
+                const std::pair<int, int>& a = record.lineEndpoints[2 * i];
+                const std::pair<int, int>& b = record.lineEndpoints[2 * i + 1];
+                buffer += (i ? ",[" : "[") + std::to_string(a.first) + ',' + std::to_string(a.second) + ',' +
+                    std::to_string(b.first) + ',' + std::to_string(b.second);
+                if (detailed) {
+                    buffer += ',';
+                    appendNumber(std::hypot(b.first - a.first, b.second - a.second), buffer);
+                    buffer += ',';
+                    appendNumber(std::atan2(b.second - a.second, b.first - a.first) * 180.0 / CV_PI, buffer);
+                }
+                buffer += ']';
+            }
+            buffer += ']';
+        }
+        buffer += '}';
+    }
+    if (record.hasCorners) {
+        buffer += ",\"corners\":{\"count\":" + std::to_string(cornerCount) + ",\"ms\":";
+        appendNumber(record.cornerMs, buffer);
+        if (withFeatures) {
+            buffer += ",\"points\":[";
+            for (size_t i = 0; i < record.corners.size(); ++i) {
+                buffer += (i ? ",[" : "[") + std::to_string(record.corners[i].first) + ',' + std::to_string(record.corners[i].second) + ']';
+            }
+            buffer += ']';
+        }
+        buffer += '}';
+    }
+    buffer += "}\n";
+}
+
+/**
+ * @brief Append a string as a quoted JSON string, escaping quotes, backslashes and control characters.
+ */
+void ResultSink::appendJsonString(const std::string& text, std::string& buffer) {
+    buffer += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            buffer += "\\\"";
+            break;
+        case '\\':
+            buffer += "\\\\";
+            break;
+        case '\n':
+            buffer += "\\n";
+            break;
+        case '\t':
+            buffer += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                buffer += escaped;
+            }
+            else {
+                buffer += c;
+            }
+            break;
+        }
+    }
+    buffer += '"';
+}
+
+/**
+ * @brief Append a string as a quoted CSV field, doubling embedded quotes.
+ */
+void ResultSink::appendCsvField(const std::string& text, std::string& buffer) {
+    buffer += '"';
+    for (char c : text) {
+        if (c == '"') {
+            buffer += '"';
+        }
+        buffer += c;
+    }
+    buffer += '"';
+}
+
+/**
+ * @brief Parse a format name.
+ *
+ * @throws std::invalid_argument if the name is unknown.
+ */
+SinkFormat ResultSink::parseFormat(const std::string& name) {
+    if (name == "ndjson") {
+        return SinkFormat::NDJSON;
+    }
+    if (name == "csv") {
+        return SinkFormat::CSV;
+    }
+    throw std::invalid_argument("Unknown result format: " + name);
+}
+
+/**
+ * @brief Parse a verbosity name.
+ *
+ * @throws std::invalid_argument if the name is unknown.
+ */
+SinkVerbosity ResultSink::parseVerbosity(const std::string& name) {
+    if (name == "summary") {
+        return SinkVerbosity::Summary;
+    }
+    if (name == "features") {
+        return SinkVerbosity::Features;
+    }
+    if (name == "detailed") {
+        return SinkVerbosity::Detailed;
+    }
+    throw std::invalid_argument("Unknown result verbosity: " + name);
+}
@@ -0,0 +1,166 @@
+/* *******************************************************
+ * Filename		:	ResultSink.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	ResultSink Class Header
+ * ******************************************************/
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class LineDetection;
+class CornerDetection;
+
+ /**
+  * @brief Record layouts written by ResultSink.
+  */
+enum class SinkFormat {
+    NDJSON,     ///< One JSON object per line
+    CSV         ///< One row per image after a header row
+};
+
+/**
+ * @brief Amount of detail in each record.
+ */
+enum class SinkVerbosity {
+    Summary,    ///< Feature counts and analysis times only
+    Features,   ///< Summary plus every feature's coordinates
+    Detailed    ///< Features plus the length and angle of every line
+};
+
+/**
+ * @brief The ResultSink class.
+ *
+ * Streams one compact record per image instead of the multi-line operator<< dumps. submit() only
+ * copies the features into a queue; a dedicated writer thread formats the records into a large
+ * buffer and writes it to the stream in blocks, so the detectors never wait for console or disk I/O.
+ * The queue is bounded, a producer that outruns the writer blocks instead of growing memory.
+ */
+class ResultSink {
+private:
+    /**
+     * @brief Features of one image, copied out of the detectors.
+     */
+    struct Record {
+        std::string image;
+        std::string error;          ///< Why the image failed, empty for a successful image
+        bool hasLines;
+        bool hasCorners;
+        double preprocessMs;        ///< Shared preprocessing time, reported once per image
+        double lineMs;
+        double cornerMs;
+        size_t lineCount;
+        size_t cornerCount;
+        std::vector<std::pair<int, int>> lineEndpoints;
+        std::vector<std::pair<int, int>> corners;
+    };
+
+    std::ostream& os;               ///< Destination of the records
+    SinkFormat format;              ///< Record layout
+    SinkVerbosity verbosity;        ///< Amount of detail per record
+    size_t capacity;                ///< Maximum number of queued records
+
+    std::deque<Record> queue;       ///< Records waiting for the writer
+    std::mutex mutex;               ///< Guards queue and closing
+    std::condition_variable ready;  ///< Signalled when a record is queued or the sink closes
+    std::condition_variable space;  ///< Signalled when the writer takes records from a full queue
+    bool closing;                   ///< Set by close()
+    std::thread writer;             ///< The writer thread
+
+    /**
+     * @brief Queue a record, waiting while the queue is full.
+     * @param record The record.
+     * @throws std::logic_error if the sink is closed.
+     */
+    void enqueue(Record&& record);
+
+    /**
+     * @brief Main loop of the writer thread.
+     */
+    void writerLoop();
+
+    /**
+     * @brief Append one formatted record to a buffer.
+     * @param record The record.
+     * @param buffer The output buffer.
+     */
+    void formatRecord(const Record& record, std::string& buffer) const;
+
+    /**
+     * @brief Append a string as a quoted JSON string.
+     * @param text The text.
+     * @param buffer The output buffer.
+     */
+    static void appendJsonString(const std::string& text, std::string& buffer);
+
+    /**
+     * @brief Append a string as a quoted CSV field.
+     * @param text The text.
+     * @param buffer The output buffer.
+     */
+    static void appendCsvField(const std::string& text, std::string& buffer);
+
+public:
+    /**
+     * @brief Constructor that starts the writer thread.
+     * @param os Destination stream, it must outlive the sink.
+     * @param format Record layout.
+     * @param verbosity Amount of detail per record.
+     * @param capacity Maximum number of queued records, must be positive.
+     * @throws std::invalid_argument if the capacity is 0.
+     */
+    ResultSink(std::ostream& os, SinkFormat format, SinkVerbosity verbosity, size_t capacity = 1024);
+
+    /**
+     * @brief Destructor that writes the remaining records.
+     */
+    ~ResultSink();
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    /**
+     * @brief Queue the results of one image.
+     * @param image Name of the image written to the record.
+     * @param lines Analyzed line detector, nullptr if lines were not detected.
+     * @param corners Analyzed corner detector, nullptr if corners were not detected.
+     * @throws std::logic_error if the sink is closed.
+     */
+    void submit(const std::string& image, const LineDetection* lines, const CornerDetection* corners);
+
+    /**
+     * @brief Queue an error record for an image that could not be processed.
+     * @param image Name of the image written to the record.
+     * @param message Description of the failure.
+     * @throws std::logic_error if the sink is closed.
+     */
+    void submitError(const std::string& image, const std::string& message);
+
+    /**
+     * @brief Write the remaining records, flush the stream and stop the writer thread.
+     */
+    void close();
+
+    /**
+     * @brief Parse a format name.
+     * @param name "ndjson" or "csv".
+     * @return The format.
+     * @throws std::invalid_argument if the name is unknown.
+     */
+    static SinkFormat parseFormat(const std::string& name);
+
+    /**
+     * @brief Parse a verbosity name.
+     * @param name "summary", "features" or "detailed".
+     * @return The verbosity.
+     * @throws std::invalid_argument if the name is unknown.
+     */
+    static SinkVerbosity parseVerbosity(const std::string& name);
+};
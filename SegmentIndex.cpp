@@ -0,0 +1,331 @@
+/* *******************************************************
+ * Filename		:	SegmentIndex.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	SegmentIndex Class Implementation
+ * ******************************************************/
+
+#include "SegmentIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+namespace {
+    /**
+     * @brief Bounding box of a segment.
+     * @param segment The segment.
+     * @return The box, with zero width or height for axis-parallel segments.
+     */
+    cv::Rect2f boundsOf(const cv::Vec4f& segment) {
+        const float x0 = std::min(segment[0], segment[2]);
+        const float y0 = std::min(segment[1], segment[3]);
+        return cv::Rect2f(x0, y0, std::max(segment[0], segment[2]) - x0, std::max(segment[1], segment[3]) - y0);
+    }
+
+    /**
+     * @brief Smallest box containing two boxes.
+     */
+    cv::Rect2f unite(const cv::Rect2f& a, const cv::Rect2f& b) {
+        const float x0 = std::min(a.x, b.x);
+        const float y0 = std::min(a.y, b.y);
+        return cv::Rect2f(x0, y0, std::max(a.x + a.width, b.x + b.width) - x0, std::max(a.y + a.height, b.y + b.height) - y0);
+    }
+
+    /**
+     * @brief Check whether two boxes overlap, borders included.
+     */
+    bool overlaps(const cv::Rect2f& a, const cv::Rect2f& b) {
+        return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+    }
+
+    /**
+     * @brief Squared distance from a point to a box, 0 inside it.
+     */
+    float boxDistanceSquared(const cv::Point2f& point, const cv::Rect2f& box) {
+        const float dx = std::max(std::max(box.x - point.x, 0.0f), point.x - (box.x + box.width));
+        const float dy = std::max(std::max(box.y - point.y, 0.0f), point.y - (box.y + box.height));
+        return dx * dx + dy * dy;
+    }
+
+    /**
+     * @brief Sign of the turn from (a, b) to (a, c): 1 counter-clockwise, -1 clockwise, 0 collinear.
+     */
+    int orientation(double ax, double ay, double bx, double by, double cx, double cy) {
+        const double cross = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+        return cross > 0.0 ? 1 : (cross < 0.0 ? -1 : 0);
+    }
+
+    /**
+     * @brief Check whether a collinear point c lies within the bounding box of (a, b).
+     */
+    bool onSegment(double ax, double ay, double bx, double by, double cx, double cy) {
+        return std::min(ax, bx) <= cx && cx <= std::max(ax, bx) && std::min(ay, by) <= cy && cy <= std::max(ay, by);
+    }
+}
+
+ /**
+  * @brief Build the index, replacing the previous content.
+  *
+  * @param input The segments.
+  */
+void SegmentIndex::build(const std::vector<cv::Vec4f>& input) {
+    segments = input;
+    order.clear();
+    children.clear();
+    nodes.clear();
+    if (segments.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<cv::Rect2f, int>> entries(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        entries[i] = std::make_pair(boundsOf(segments[i]), static_cast<int>(i));
+    }
+    order.reserve(segments.size());
+    std::vector<int> level = packLevel(entries, true);
+
+    while (level.size() > 1) {
+        entries.resize(level.size());
+        for (size_t i = 0; i < level.size(); ++i) {
+            entries[i] = std::make_pair(nodes[level[i]].box, level[i]);
+        }
+        level = packLevel(entries, false);
+    }
+}
+
+/**
+ * @brief Pack boxes into nodes of one level with Sort-Tile-Recursive ordering.
+ *
+ * @return std::vector<int> Indices of the nodes created.
+ */
+std::vector<int> SegmentIndex::packLevel(std::vector<std::pair<cv::Rect2f, int>>& entries, bool leaf) {
+    auto centerX = [](const std::pair<cv::Rect2f, int>& e) { return e.first.x + e.first.width * 0.5f; };
+    auto centerY = [](const std::pair<cv::Rect2f, int>& e) { return e.first.y + e.first.height * 0.5f; };
+
+    const size_t nodeCount = (entries.size() + nodeCapacity - 1) / nodeCapacity;
+    const size_t sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodeCount))));
+    const size_t sliceSize = sliceCount * nodeCapacity;
+
+    std::sort(entries.begin(), entries.end(), [&](const std::pair<cv::Rect2f, int>& a, const std::pair<cv::Rect2f, int>& b) {
+        return centerX(a) < centerX(b);
+    });
+    for (size_t start = 0; start < entries.size(); start += sliceSize) {
+        const size_t end = std::min(entries.size(), start + sliceSize);
+        std::sort(entries.begin() + start, entries.begin() + end, [&](const std::pair<cv::Rect2f, int>& a, const std::pair<cv::Rect2f, int>& b) {
+            return centerY(a) < centerY(b);
+        });
+    }
+
+    std::vector<int> created;
+    created.reserve(nodeCount);
+    std::vector<int>& targets = leaf ? order : children;
+    for (size_t start = 0; start < entries.size(); start += nodeCapacity) {
+        const size_t end = std::min(entries.size(), start + static_cast<size_t>(nodeCapacity));
+        Node node;
+        node.box = entries[start].first;
+        node.first = static_cast<int>(targets.size());
+        node.count = static_cast<int>(end - start);
+        node.leaf = leaf;
+        for (size_t i = start; i < end; ++i) {
+            node.box = unite(node.box, entries[i].first);
+            targets.push_back(entries[i].second);
+        }
+        created.push_back(static_cast<int>(nodes.size()));
+        nodes.push_back(node);
+    }
+    return created;
+}
+
+/**
+ * @brief Get the number of indexed segments.
+ *
+ * @return size_t The number of segments.
+ */
+size_t SegmentIndex::size() const {
+    return segments.size();
+}
+
+/**
+ * @brief Get the number of bytes held by the index.
+ *
+ * @return size_t The memory in bytes.
+ */
+size_t SegmentIndex::memoryBytes() const {
+    return segments.capacity() * sizeof(cv::Vec4f) + (order.capacity() + children.capacity()) * sizeof(int) +
+        nodes.capacity() * sizeof(Node);
+}
+
+/**
+ * @brief Find the segments that cross or lie inside a box.
+ *
+ * Subtrees whose box misses the query are skipped, the segments of the remaining leaves are
+ * clipped against the query box.
+ */
+void SegmentIndex::queryBox(const cv::Rect2f& box, std::vector<int>& result) const {
+    result.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    std::vector<int> stack(1, static_cast<int>(nodes.size()) - 1);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!overlaps(node.box, box)) {
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            if (node.leaf) {
+                if (intersects(segments[order[i]], box)) {
+                    result.push_back(order[i]);
+                }
+            }
+            else {
+                stack.push_back(children[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find the segments that intersect a query segment.
+ */
+void SegmentIndex::queryIntersecting(const cv::Vec4f& segment, std::vector<int>& result) const {
+    result.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    const cv::Rect2f bounds = boundsOf(segment);
+    std::vector<int> stack(1, static_cast<int>(nodes.size()) - 1);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (!overlaps(node.box, bounds) || !intersects(segment, node.box)) {
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            if (node.leaf) {
+                if (intersects(segments[order[i]], segment)) {
+                    result.push_back(order[i]);
+                }
+            }
+            else {
+                stack.push_back(children[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find the k segments nearest to a query point.
+ *
+ * Best-first search: nodes and segments share one priority queue keyed by distance. A node's box
+ * distance is a lower bound for everything below it, so segments leave the queue in exact order.
+ */
+void SegmentIndex::nearest(const cv::Point2f& query, int k, std::vector<int>& result) const {
+    result.clear();
+    if (nodes.empty() || k <= 0) {
+        return;
+    }
+
+    // (squared distance, is a segment, node or segment index), smallest distance on top.
+    typedef std::tuple<float, bool, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    const int root = static_cast<int>(nodes.size()) - 1;
+    queue.emplace(boxDistanceSquared(query, nodes[root].box), false, root);
+
+    while (!queue.empty() && static_cast<int>(result.size()) < k) {
+        const Entry entry = queue.top();
+        queue.pop();
+        if (std::get<1>(entry)) {
+            result.push_back(std::get<2>(entry));
+            continue;
+        }
+        const Node& node = nodes[std::get<2>(entry)];
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            if (node.leaf) {
+                queue.emplace(distanceSquared(query, segments[order[i]]), true, order[i]);
+            }
+            else {
+                queue.emplace(boxDistanceSquared(query, nodes[children[i]].box), false, children[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Squared distance from a point to a segment.
+ *
+ * @return float The squared distance.
+ */
+float SegmentIndex::distanceSquared(const cv::Point2f& point, const cv::Vec4f& segment) {
+    const float dx = segment[2] - segment[0];
+    const float dy = segment[3] - segment[1];
+    const float lengthSquared = dx * dx + dy * dy;
+    float t = 0.0f;
+    if (lengthSquared > 0.0f) {
+        t = std::min(1.0f, std::max(0.0f, ((point.x - segment[0]) * dx + (point.y - segment[1]) * dy) / lengthSquared));
+    }
+    const float ex = segment[0] + t * dx - point.x;
+    const float ey = segment[1] + t * dy - point.y;
+    return ex * ex + ey * ey;
+}
+
+/**
+ * @brief Check whether two segments intersect with orientation tests in double precision.
+ *
+ * @return bool True if they intersect.
+ */
+bool SegmentIndex::intersects(const cv::Vec4f& a, const cv::Vec4f& b) {
+    const int o1 = orientation(a[0], a[1], a[2], a[3], b[0], b[1]);
+    const int o2 = orientation(a[0], a[1], a[2], a[3], b[2], b[3]);
+    const int o3 = orientation(b[0], b[1], b[2], b[3], a[0], a[1]);
+    const int o4 = orientation(b[0], b[1], b[2], b[3], a[2], a[3]);
+
+    if (o1 != o2 && o3 != o4) {
+        return true;
+    }
+    return (o1 == 0 && onSegment(a[0], a[1], a[2], a[3], b[0], b[1])) ||
+        (o2 == 0 && onSegment(a[0], a[1], a[2], a[3], b[2], b[3])) ||
+        (o3 == 0 && onSegment(b[0], b[1], b[2], b[3], a[0], a[1])) ||
+        (o4 == 0 && onSegment(b[0], b[1], b[2], b[3], a[2], a[3]));
+}
+
+/**
+ * @brief Check whether a segment crosses or lies inside a box with Liang-Barsky clipping.
+ *
+ * @return bool True if any point of the segment is in the box.
+ */
+bool SegmentIndex::intersects(const cv::Vec4f& segment, const cv::Rect2f& box) {
+    const double dx = static_cast<double>(segment[2]) - segment[0];
+    const double dy = static_cast<double>(segment[3]) - segment[1];
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { segment[0] - static_cast<double>(box.x), static_cast<double>(box.x) + box.width - segment[0],
+        segment[1] - static_cast<double>(box.y), static_cast<double>(box.y) + box.height - segment[1] };
+
+    double t0 = 0.0;
+    double t1 = 1.0;
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0) {
+                return false;
+            }
+        }
+        else {
+            const double t = q[i] / p[i];
+            if (p[i] < 0.0) {
+                t0 = std::max(t0, t);
+            }
+            else {
+                t1 = std::min(t1, t);
+            }
+            if (t0 > t1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
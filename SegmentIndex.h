@@ -0,0 +1,114 @@
+/* *******************************************************
+ * Filename		:	SegmentIndex.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	SegmentIndex Class Header
+ * ******************************************************/
+
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <cstddef>
+
+ /**
+  * @brief Packed R-tree over a static set of line segments.
+  *
+  * The tree is bulk-loaded with Sort-Tile-Recursive packing: the bounding boxes are sorted into
+  * vertical slices by x, each slice is sorted by y and cut into full nodes, and the same packing
+  * builds every upper level. Nodes are stored in one flat array, so the whole tree takes about one
+  * box per sixteen segments on top of the segments themselves. Box queries and segment intersection
+  * queries test the exact segment geometry, not only the bounding boxes. Results are indices into
+  * the vector the index was built from.
+  */
+class SegmentIndex {
+private:
+    /**
+     * @brief Node of the tree, leaves refer to segments, inner nodes to other nodes.
+     */
+    struct Node {
+        cv::Rect2f box;     ///< Bounding box of everything below the node
+        int first;          ///< First entry in order (leaf) or children (inner node)
+        int count;          ///< Number of entries
+        bool leaf;          ///< True if the entries are segments
+    };
+
+    static const int nodeCapacity = 16;     ///< Maximum number of entries per node
+
+    std::vector<cv::Vec4f> segments;    ///< Segments in input order
+    std::vector<int> order;             ///< Segment indices in leaf order
+    std::vector<int> children;          ///< Child node indices of the inner nodes
+    std::vector<Node> nodes;            ///< All nodes, the root is the last one
+
+    /**
+     * @brief Pack boxes into nodes of one level and append them to the node array.
+     * @param entries Boxes with the segment or node index they stand for.
+     * @param leaf True if the entries are segments.
+     * @return Indices of the nodes created.
+     */
+    std::vector<int> packLevel(std::vector<std::pair<cv::Rect2f, int>>& entries, bool leaf);
+
+public:
+    /**
+     * @brief Build the index, replacing the previous content.
+     * @param input The segments as (x1, y1, x2, y2).
+     */
+    void build(const std::vector<cv::Vec4f>& input);
+
+    /**
+     * @brief Get the number of indexed segments.
+     * @return The number of segments.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of bytes held by the index.
+     * @return The memory in bytes.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Find the segments that cross or lie inside a box, borders included.
+     * @param box The query box.
+     * @param result Cleared and set to the indices of the segments found.
+     */
+    void queryBox(const cv::Rect2f& box, std::vector<int>& result) const;
+
+    /**
+     * @brief Find the segments that intersect a query segment.
+     * @param segment The query segment as (x1, y1, x2, y2).
+     * @param result Cleared and set to the indices of the segments found.
+     */
+    void queryIntersecting(const cv::Vec4f& segment, std::vector<int>& result) const;
+
+    /**
+     * @brief Find the k segments nearest to a query point.
+     * @param query The query point.
+     * @param k Number of neighbours.
+     * @param result Cleared and set to the indices of at most k segments, nearest first.
+     */
+    void nearest(const cv::Point2f& query, int k, std::vector<int>& result) const;
+
+    /**
+     * @brief Squared distance from a point to a segment.
+     * @param point The point.
+     * @param segment The segment as (x1, y1, x2, y2).
+     * @return The squared distance.
+     */
+    static float distanceSquared(const cv::Point2f& point, const cv::Vec4f& segment);
+
+    /**
+     * @brief Check whether two segments intersect, touching and collinear overlap included.
+     * @param a The first segment.
+     * @param b The second segment.
+     * @return True if they intersect.
+     */
+    static bool intersects(const cv::Vec4f& a, const cv::Vec4f& b);
+
+    /**
+     * @brief Check whether a segment crosses or lies inside a box.
+     * @param segment The segment.
+     * @param box The box, borders included.
+     * @return True if any point of the segment is in the box.
+     */
+    static bool intersects(const cv::Vec4f& segment, const cv::Rect2f& box);
+};
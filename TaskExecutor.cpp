@@ -0,0 +1,161 @@
+/* *******************************************************
+ * Filename		:	TaskExecutor.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	TaskExecutor Class Implementation
+ * ******************************************************/
+
+#include "TaskExecutor.h"
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief The executor the calling thread works for, nullptr on other threads.
+     */
+    thread_local const TaskExecutor* currentExecutor = nullptr;
+
+    /**
+     * @brief Index of the calling worker's deque.
+     */
+    thread_local size_t currentQueue = 0;
+}
+
+ /**
+  * @brief Constructor that starts the workers.
+  *
+  * @param threadCount Number of workers, 0 uses the number of hardware threads.
+  */
+TaskExecutor::TaskExecutor(int threadCount) : pending(0), nextQueue(0), stopping(false) {
+    const size_t count = threadCount > 0 ? static_cast<size_t>(threadCount) : std::max(2u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < count; ++i) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(&TaskExecutor::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Destructor that runs the remaining tasks and joins the workers.
+ */
+TaskExecutor::~TaskExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Get the number of workers.
+ *
+ * @return size_t The number of worker threads.
+ */
+size_t TaskExecutor::size() const {
+    return threads.size();
+}
+
+/**
+ * @brief Queue a task.
+ *
+ * The pending counter is raised under the deque's lock together with the push, so a worker can
+ * never take the task and decrement the counter first. It is raised before the wake-up is signalled
+ * under wakeMutex, so a worker that checked the counter just before cannot miss the signal.
+ *
+ * @param task The task.
+ */
+void TaskExecutor::post(std::function<void()> task) {
+    const size_t index = currentExecutor == this ? currentQueue : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+        ++pending;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Take a task, first from the back of the given deque, then from the front of the others.
+ *
+ * @return bool False if every deque is empty.
+ */
+bool TaskExecutor::takeTask(size_t index, std::function<void()>& task) {
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --pending;
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --pending;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Run one queued task on the calling thread.
+ *
+ * @return bool False if no task was queued.
+ */
+bool TaskExecutor::runPendingTask() {
+    std::function<void()> task;
+    const size_t index = currentExecutor == this ? currentQueue : nextQueue.load() % queues.size();
+    if (!takeTask(index, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+/**
+ * @brief Main loop of one worker.
+ *
+ * Sleeps only while nothing is pending and leaves once the pool stops and every task has run.
+ *
+ * @param index Index of the worker's deque.
+ */
+void TaskExecutor::workerLoop(size_t index) {
+    currentExecutor = this;
+    currentQueue = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+        if (stopping && pending.load() == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Get the process-wide executor.
+ *
+ * @return TaskExecutor& The executor.
+ */
+TaskExecutor& TaskExecutor::shared() {
+    static TaskExecutor executor;
+    return executor;
+}
@@ -0,0 +1,111 @@
+/* *******************************************************
+ * Filename		:	TaskExecutor.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	TaskExecutor Class Header
+ * ******************************************************/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ /**
+  * @brief Work-stealing thread pool.
+  *
+  * Every worker owns a deque. Tasks posted from a worker go to the back of its own deque and are
+  * taken from the back again, so dependent tasks run hot in the same cache; tasks posted from other
+  * threads are spread round-robin. An idle worker steals from the front of the other deques.
+  * Threads waiting for a result can lend a hand with runPendingTask() instead of blocking a worker.
+  */
+class TaskExecutor {
+private:
+    /**
+     * @brief Task deque of one worker.
+     */
+    struct WorkerQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;  ///< One deque per worker
+    std::vector<std::thread> threads;                   ///< The workers
+    std::mutex wakeMutex;                               ///< Guards the sleep and wake-up of idle workers
+    std::condition_variable wake;                       ///< Signalled when a task is posted or the pool stops
+    std::atomic<size_t> pending;                        ///< Tasks posted but not yet taken
+    std::atomic<size_t> nextQueue;                      ///< Round-robin position for tasks posted from outside
+    bool stopping;                                      ///< Set by the destructor, guarded by wakeMutex
+
+    /**
+     * @brief Take a task, first from the back of the given deque, then from the front of the others.
+     * @param index The deque to start with.
+     * @param task Set to the task taken.
+     * @return False if every deque is empty.
+     */
+    bool takeTask(size_t index, std::function<void()>& task);
+
+    /**
+     * @brief Main loop of one worker.
+     * @param index Index of the worker's deque.
+     */
+    void workerLoop(size_t index);
+
+public:
+    /**
+     * @brief Constructor that starts the workers.
+     * @param threadCount Number of workers, 0 uses the number of hardware threads.
+     */
+    explicit TaskExecutor(int threadCount = 0);
+
+    /**
+     * @brief Destructor that runs the remaining tasks and joins the workers.
+     */
+    ~TaskExecutor();
+
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    /**
+     * @brief Get the number of workers.
+     * @return The number of worker threads.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Queue a task, its exceptions must be handled by the task itself.
+     * @param task The task.
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief Queue a callable and get a future for its result.
+     * @param fn The callable, exceptions are delivered through the future.
+     * @return The future.
+     */
+    template<typename Function>
+    auto submit(Function fn) -> std::future<decltype(fn())> {
+        typedef decltype(fn()) Result;
+        std::shared_ptr<std::packaged_task<Result()>> task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        std::future<Result> result = task->get_future();
+        post([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Run one queued task on the calling thread.
+     * @return False if no task was queued.
+     */
+    bool runPendingTask();
+
+    /**
+     * @brief Get the process-wide executor.
+     * @return The executor, started on first use with one worker per hardware thread.
+     */
+    static TaskExecutor& shared();
+};
@@ -0,0 +1,151 @@
+/* *******************************************************
+ * Filename		:	TaskGraph.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	TaskGraph Class Implementation
+ * ******************************************************/
+
+#include "TaskGraph.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief State shared by the tasks of one TaskGraph::run() call.
+     */
+    struct GraphRun {
+        std::vector<std::atomic<int>> waiting;  ///< Unfinished dependencies per task
+        std::vector<std::atomic<bool>> failed;  ///< Set when the task or one of its dependencies threw
+        size_t unfinished;                      ///< Tasks not finished yet, guarded by mutex
+        size_t finished;                        ///< Tasks finished so far, guarded by mutex
+        std::string error;                      ///< Message of the first failure, guarded by mutex
+        std::mutex mutex;
+        std::condition_variable done;
+
+        explicit GraphRun(size_t count) : waiting(count), failed(count), unfinished(count), finished(0) {}
+    };
+}
+
+ /**
+  * @brief Add a task.
+  *
+  * @return size_t Id of the new task.
+  * @throws std::invalid_argument if a dependency id is unknown.
+  */
+size_t TaskGraph::add(const std::string& name, std::function<void()> work, const std::vector<size_t>& dependencies) {
+    const size_t id = nodes.size();
+    for (size_t dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::invalid_argument("Task " + name + " depends on an unknown task");
+        }
+    }
+    for (size_t dependency : dependencies) {
+        nodes[dependency].dependents.push_back(id);
+    }
+    nodes.push_back({ name, std::move(work), std::vector<size_t>(), static_cast<int>(dependencies.size()) });
+    return id;
+}
+
+/**
+ * @brief Get the number of tasks.
+ *
+ * @return size_t The number of tasks.
+ */
+size_t TaskGraph::size() const {
+    return nodes.size();
+}
+
+/**
+ * @brief Run every task and wait for the graph to finish.
+ *
+ * The tasks without dependencies are posted first. A finishing task decrements the counters of its
+ * dependents and posts the ones that reach zero. The calling thread runs queued tasks while it waits,
+ * so running a graph from inside a task does not tie up a worker.
+ *
+ * @throws std::runtime_error naming the task if any task threw.
+ */
+void TaskGraph::run(TaskExecutor& executor) const {
+    if (nodes.empty()) {
+        return;
+    }
+
+    std::shared_ptr<GraphRun> state = std::make_shared<GraphRun>(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        state->waiting[i] = nodes[i].dependencies;
+        state->failed[i] = false;
+    }
+
+    std::shared_ptr<std::function<void(size_t)>> start = std::make_shared<std::function<void(size_t)>>();
+    std::weak_ptr<std::function<void(size_t)>> weakStart = start;
+    *start = [this, state, weakStart, &executor](size_t id) {
+        executor.post([this, state, weakStart, id]() {
+            const Node& node = nodes[id];
+            if (!state->failed[id]) {
+                try {
+                    node.work();
+                }
+                catch (const std::exception& ex) {
+                    state->failed[id] = true;
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->error.empty()) {
+                        state->error = "Task " + node.name + " failed: " + ex.what();
+                    }
+                }
+                catch (...) {
+                    state->failed[id] = true;
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->error.empty()) {
+                        state->error = "Task " + node.name + " failed";
+                    }
+                }
+            }
+
+            for (size_t dependent : node.dependents) {
+                if (state->failed[id]) {
+                    state->failed[dependent] = true;
+                }
+                if (--state->waiting[dependent] == 0) {
+                    std::shared_ptr<std::function<void(size_t)>> next = weakStart.lock();
+                    if (next) {
+                        (*next)(dependent);
+                    }
+                }
+            }
+
+            // Every completion wakes the caller, its dependents may have been queued for it to help with
+            std::lock_guard<std::mutex> lock(state->mutex);
+            --state->unfinished;
+            ++state->finished;
+            state->done.notify_all();
+        });
+    };
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].dependencies == 0) {
+            (*start)(i);
+        }
+    }
+
+    // Help the executor until the last task has finished. With nothing queued the caller sleeps until
+    // the next task of this graph finishes, the only event that can queue more of its work.
+    while (true) {
+        size_t seen;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->unfinished == 0) {
+                break;
+            }
+            seen = state->finished;
+        }
+        if (!executor.runPendingTask()) {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->done.wait(lock, [&state, seen]() { return state->unfinished == 0 || state->finished != seen; });
+        }
+    }
+
+    if (!state->error.empty()) {
+        throw std::runtime_error(state->error);
+    }
+}
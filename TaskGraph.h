@@ -0,0 +1,61 @@
+/* *******************************************************
+ * Filename		:	TaskGraph.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	TaskGraph Class Header
+ * ******************************************************/
+
+#pragma once
+#include "TaskExecutor.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief A small graph of dependent tasks run on a TaskExecutor.
+  *
+  * Tasks are added in dependency order: a task can only depend on tasks added before it, so the
+  * graph cannot contain cycles. Each task is posted as soon as its last dependency finishes, which
+  * makes the latency of the whole graph approach that of its longest chain.
+  */
+class TaskGraph {
+private:
+    /**
+     * @brief One task and the tasks waiting for it.
+     */
+    struct Node {
+        std::string name;
+        std::function<void()> work;
+        std::vector<size_t> dependents;
+        int dependencies;
+    };
+
+    std::vector<Node> nodes;    ///< Tasks in the order they were added
+
+public:
+    /**
+     * @brief Add a task.
+     * @param name Name of the task used in error messages.
+     * @param work The work to be done.
+     * @param dependencies Ids of the tasks that must finish first.
+     * @return Id of the new task.
+     * @throws std::invalid_argument if a dependency id is unknown.
+     */
+    size_t add(const std::string& name, std::function<void()> work, const std::vector<size_t>& dependencies = std::vector<size_t>());
+
+    /**
+     * @brief Get the number of tasks.
+     * @return The number of tasks.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Run every task and wait for the graph to finish, helping the executor while waiting.
+     *
+     * When a task throws, the tasks depending on it are skipped, independent branches still run.
+     *
+     * @param executor The executor the tasks are posted to.
+     * @throws std::runtime_error naming the task if any task threw.
+     */
+    void run(TaskExecutor& executor) const;
+};
@@ -0,0 +1,452 @@
+/* *******************************************************
+ * Filename		:	WorkQueue.cpp
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	WorkQueue Class Implementation
+ * ******************************************************/
+
+#include "WorkQueue.h"
+#include "LineDetection.h"
+#include "CornerDetection.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    /**
+     * @brief Build a worker name from the host name and process id.
+     * @return The worker id.
+     */
+    std::string makeWorkerId() {
+        const char* host = std::getenv("COMPUTERNAME");
+        if (host == nullptr) {
+            host = std::getenv("HOSTNAME");
+        }
+        return std::string(host != nullptr ? host : "worker") + "-" + std::to_string(getpid());
+    }
+
+    /**
+     * @brief Build a token that identifies one claim of a shard.
+     * @param workerId The worker id.
+     * @return The token, unique even if two machines share a worker id.
+     */
+    std::string makeClaimToken(const std::string& workerId) {
+        std::random_device device;
+        std::ostringstream token;
+        token << workerId << "-" << std::hex << device() << device();
+        return token.str();
+    }
+
+    /**
+     * @brief Thread that renews a lease at a fixed interval until it is destroyed.
+     *
+     * Renewing only between images would let a single image that runs longer than the lease time
+     * lose the shard while it is still being processed.
+     */
+    class LeaseHeartbeat {
+    private:
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping = false;
+        std::atomic<bool> lost{ false };
+        std::thread thread;
+
+    public:
+        /**
+         * @brief Start renewing.
+         * @param renew Renews the lease, returns false if it was lost.
+         * @param interval Time between two renewals.
+         */
+        LeaseHeartbeat(std::function<bool()> renew, std::chrono::seconds interval)
+            : thread([this, renew, interval]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (!wake.wait_for(lock, interval, [this]() { return stopping; })) {
+                    if (!renew()) {
+                        lost = true;
+                        return;
+                    }
+                }
+            }) {
+        }
+
+        /**
+         * @brief Stop renewing and join the thread.
+         */
+        ~LeaseHeartbeat() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            thread.join();
+        }
+
+        /**
+         * @brief Check whether a renewal failed.
+         * @return True if the lease was lost.
+         */
+        bool leaseLost() const {
+            return lost;
+        }
+    };
+}
+
+/**
+ * @brief Constructor that attaches to an existing queue directory.
+ *
+ * @param queueDir The queue directory.
+ * @param leaseSeconds Lease time in seconds.
+ * @throws std::runtime_error if the directory is not an initialized queue or the lease time is not positive.
+ */
+WorkQueue::WorkQueue(const std::string& queueDir, int leaseSeconds)
+    : root(queueDir), workerId(makeWorkerId()), leaseSeconds(leaseSeconds), clockFile(root / "clocks" / workerId) {
+    if (leaseSeconds <= 0) {
+        throw std::runtime_error("Lease time must be positive");
+    }
+    for (const char* name : { "pending", "leased", "done", "results" }) {
+        if (!fs::is_directory(root / name)) {
+            throw std::runtime_error("Not an initialized work queue: " + queueDir);
+        }
+    }
+    fs::create_directories(root / "clocks");
+}
+
+/**
+ * @brief Create a queue from a manifest of image paths.
+ *
+ * Shards are written to the queue directory first and renamed into pending/, so a worker never
+ * sees a partially written shard.
+ */
+int WorkQueue::create(const std::string& manifest, const std::string& queueDir, int shardSize) {
+    if (shardSize <= 0) {
+        throw std::runtime_error("Shard size must be positive");
+    }
+
+    std::ifstream inFile(manifest);
+    if (!inFile.is_open()) {
+        throw std::runtime_error("Could not open the manifest: " + manifest);
+    }
+
+    const fs::path root(queueDir);
+    if (fs::exists(root / "pending")) {
+        throw std::runtime_error("Work queue already exists: " + queueDir);
+    }
+    for (const char* name : { "pending", "leased", "done", "results", "clocks" }) {
+        fs::create_directories(root / name);
+    }
+
+    std::vector<std::string> images;
+    std::string line;
+    while (std::getline(inFile, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            images.push_back(line);
+        }
+    }
+
+    int shards = 0;
+    for (size_t first = 0; first < images.size(); first += shardSize) {
+        std::ostringstream name;
+        name << "shard-" << std::setw(6) << std::setfill('0') << shards << ".txt";
+
+        const fs::path temporary = root / (name.str() + ".tmp");
+        std::ofstream outFile(temporary);
+        for (size_t i = first; i < std::min(images.size(), first + shardSize); ++i) {
+            outFile << images[i] << "\n";
+        }
+        outFile.close();
+        if (outFile.fail()) {
+            throw std::runtime_error("Failed to write shard: " + temporary.string());
+        }
+        fs::rename(temporary, root / "pending" / name.str());
+        ++shards;
+    }
+    return shards;
+}
+
+/**
+ * @brief Read the current time of the storage holding the queue.
+ *
+ * Writing the clock file lets the file server stamp its modification time, so every heartbeat and
+ * expiry check is measured against the same clock no matter which machine runs the worker.
+ *
+ * @return bool False if the clock file could not be written.
+ */
+bool WorkQueue::storageNow(fs::file_time_type& now) const {
+    std::ofstream outFile(clockFile, std::ios::trunc);
+    outFile << workerId << "\n";
+    outFile.close();
+    if (outFile.fail()) {
+        return false;
+    }
+    std::error_code ec;
+    now = fs::last_write_time(clockFile, ec);
+    return !ec;
+}
+
+/**
+ * @brief Get the shard file name of a leased path, without the claim token.
+ *
+ * @return std::string The shard file name.
+ */
+std::string WorkQueue::shardName(const fs::path& leased) {
+    const std::string name = leased.filename().string();
+    return name.substr(0, name.find('@'));
+}
+
+/**
+ * @brief Move shards whose lease expired back to pending/.
+ *
+ * Several workers may recover the same shard at once, the rename lets only one of them succeed.
+ * The shard goes back under its plain name, which invalidates the token of the previous owner.
+ */
+int WorkQueue::recoverExpiredLeases() const {
+    int recovered = 0;
+    fs::file_time_type now;
+    if (!storageNow(now)) {
+        return 0;
+    }
+    std::error_code ec;
+
+    for (const fs::directory_entry& entry : fs::directory_iterator(root / "leased", ec)) {
+        std::error_code entryError;
+        const auto heartbeat = fs::last_write_time(entry.path(), entryError);
+        if (entryError || now - heartbeat < std::chrono::seconds(leaseSeconds)) {
+            continue;
+        }
+        fs::rename(entry.path(), root / "pending" / shardName(entry.path()), entryError);
+        if (!entryError) {
+            std::cout << workerId << ": recovered expired lease " << entry.path().filename().string() << "\n";
+            ++recovered;
+        }
+    }
+    return recovered;
+}
+
+/**
+ * @brief Claim one pending shard.
+ *
+ * Workers start scanning at different offsets to spread contention. The shard is touched before
+ * the rename so that the lease starts fresh and cannot be recovered as expired right after the claim.
+ * The leased name carries a new claim token, so only this claim can renew or complete it.
+ */
+fs::path WorkQueue::claimShard() const {
+    std::vector<fs::path> pending;
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(root / "pending", ec)) {
+        pending.push_back(entry.path());
+    }
+    if (pending.empty()) {
+        return fs::path();
+    }
+    std::sort(pending.begin(), pending.end());
+
+    fs::file_time_type now;
+    if (!storageNow(now)) {
+        return fs::path();
+    }
+
+    const size_t start = std::hash<std::string>()(workerId) % pending.size();
+    for (size_t k = 0; k < pending.size(); ++k) {
+        const fs::path& shard = pending[(start + k) % pending.size()];
+        std::error_code claimError;
+        fs::last_write_time(shard, now, claimError);
+        if (claimError) {
+            continue;
+        }
+        const fs::path leased = root / "leased" / (shard.filename().string() + "@" + makeClaimToken(workerId));
+        fs::rename(shard, leased, claimError);
+        if (!claimError) {
+            return leased;
+        }
+    }
+    return fs::path();
+}
+
+/**
+ * @brief Renew the lease of a claimed shard by touching it with the storage's time.
+ *
+ * The path carries this worker's claim token. Once the lease was recovered the file no longer
+ * exists under that name, even if another worker claimed the same shard again.
+ *
+ * @return bool False if the shard is no longer leased by this claim.
+ */
+bool WorkQueue::renewLease(const fs::path& shard) const {
+    fs::file_time_type now;
+    if (!storageNow(now)) {
+        return false;
+    }
+    std::error_code ec;
+    fs::last_write_time(shard, now, ec);
+    return !ec;
+}
+
+/**
+ * @brief Run the detectors on every image of a claimed shard that has no results yet.
+ *
+ * Result files are written under a temporary name and renamed, so a crash never leaves a partial
+ * result behind. The corner file is written last and marks the image as done. Images that fail
+ * get an error file instead, so one bad image cannot block the shard; if even that cannot be
+ * written the image is left without results and retried by the next owner of the shard.
+ *
+ * The lease is renewed from a heartbeat thread every third of the lease time, so a slow image does
+ * not let the lease expire. The heartbeat is the only caller of renewLease while the shard is processed.
+ */
+bool WorkQueue::processShard(const fs::path& shard) const {
+    std::ifstream inFile(shard);
+    if (!inFile.is_open()) {
+        return false;
+    }
+
+    const fs::path resultDir = root / "results" / fs::path(shardName(shard)).stem();
+    std::error_code ec;
+    fs::create_directories(resultDir, ec);
+    if (ec) {
+        std::cerr << workerId << ": could not create " << resultDir.string() << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    LeaseHeartbeat heartbeat([this, &shard]() { return renewLease(shard); },
+        std::chrono::seconds(std::max(1, leaseSeconds / 3)));
+
+    std::string image;
+    for (int index = 0; std::getline(inFile, image); ++index) {
+        if (heartbeat.leaseLost()) {
+            return false;
+        }
+
+        const std::string base = (resultDir / std::to_string(index)).string();
+        const fs::path linesFile = base + ".lines.txt";
+        const fs::path cornersFile = base + ".corners.txt";
+        const fs::path errorFile = base + ".error.txt";
+        const std::string temporary = base + "." + workerId + ".tmp";
+
+        if (fs::exists(cornersFile, ec) || fs::exists(errorFile, ec)) {
+            continue;
+        }
+
+        try {
+            LineDetection lineDetection(image);
+            lineDetection.analyzeFeatures();
+            lineDetection.writeFeaturesToFile(temporary);
+            fs::rename(temporary, linesFile);
+
+            CornerDetection cornerDetection(image);
+            cornerDetection.analyzeFeatures();
+            cornerDetection.writeFeaturesToFile(temporary);
+            fs::rename(temporary, cornersFile);
+        }
+        catch (const std::exception& ex) {
+            std::cerr << workerId << ": " << image << ": " << ex.what() << std::endl;
+            std::ofstream errorOut(temporary);
+            errorOut << image << ": " << ex.what() << "\n";
+            errorOut.close();
+            if (errorOut) {
+                fs::rename(temporary, errorFile, ec);
+            }
+            else {
+                ec = std::make_error_code(std::errc::io_error);
+            }
+            if (ec) {
+                std::cerr << workerId << ": could not record the error of " << image << ": " << ec.message() << std::endl;
+                fs::remove(temporary, ec);
+            }
+        }
+    }
+    return !heartbeat.leaseLost();
+}
+
+/**
+ * @brief Process shards until the queue is drained.
+ *
+ * While other workers still hold leases this worker waits, so it can take over their shards if
+ * they crash and their leases expire.
+ */
+int WorkQueue::runWorker() {
+    int completed = 0;
+
+    while (true) {
+        recoverExpiredLeases();
+
+        const fs::path shard = claimShard();
+        if (shard.empty()) {
+            if (countFiles("pending") == 0 && countFiles("leased") == 0) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        const std::string name = shardName(shard);
+        std::cout << workerId << ": claimed " << name << "\n";
+        if (!processShard(shard)) {
+            std::cerr << workerId << ": lost the lease of " << name << std::endl;
+            continue;
+        }
+
+        // Renaming the tokened path fails if the lease was recovered, so a stale owner cannot complete the shard
+        std::error_code ec;
+        if (renewLease(shard)) {
+            fs::rename(shard, root / "done" / name, ec);
+        }
+        else {
+            ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        }
+        if (ec) {
+            std::cerr << workerId << ": lost the lease of " << name << std::endl;
+            continue;
+        }
+        std::cout << workerId << ": completed " << name << "\n";
+        ++completed;
+    }
+
+    return completed;
+}
+
+/**
+ * @brief Count the regular files in a queue subdirectory.
+ *
+ * @return size_t The number of files.
+ */
+size_t WorkQueue::countFiles(const std::string& name) const {
+    size_t count = 0;
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(root / name, ec)) {
+        if (entry.is_regular_file(ec)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Print the number of pending, leased and completed shards.
+ *
+ * @param os The output stream.
+ */
+void WorkQueue::printStatus(std::ostream& os) const {
+    os << "Pending: " << countFiles("pending") << ", leased: " << countFiles("leased")
+        << ", done: " << countFiles("done") << std::endl;
+}
@@ -0,0 +1,119 @@
+/* *******************************************************
+ * Filename		:	WorkQueue.h
+ * Author		:	Muhammet Mert KU
+ * Date			:	18.10.2026
+ * Description	:	WorkQueue Class Header
+ * ******************************************************/
+
+#pragma once
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+ /**
+  * @brief File-based work queue shared by detection workers on many machines.
+  *
+  * The queue is a directory on a shared filesystem, no coordinator service is needed:
+  *  - pending/ holds shards, text files with one image path per line,
+  *  - leased/ holds the shards currently claimed by a worker as <shard>@<token>, where the token is unique
+  *    to the claim and the file's modification time is the lease heartbeat,
+  *  - done/ holds completed shards,
+  *  - results/<shard>/ holds the per-image feature files,
+  *  - clocks/ holds one file per worker that is rewritten to read the current time of the storage.
+  *
+  * Every state change is a single rename, which is atomic on a shared filesystem, so exactly one worker
+  * wins a claim. A worker renews its lease from a heartbeat thread while it processes the shard.
+  * Leases that are not renewed within the lease time are moved back to pending/ by any worker, and
+  * images that already have results are skipped, so a crashed worker's shard is resumed where it stopped. A worker whose lease expired no longer finds its leased file under its token, so
+  * it can neither renew the lease nor complete the shard once someone else may have claimed it.
+  * Heartbeats and expiry use the storage's clock, so clock skew between the machines does not matter.
+  */
+class WorkQueue {
+private:
+    std::filesystem::path root;     ///< Queue directory
+    std::string workerId;           ///< Name of this worker used in log messages
+    int leaseSeconds;               ///< Lease time after which a claimed shard is considered abandoned
+    std::filesystem::path clockFile;    ///< File rewritten to read the storage's clock
+
+    /**
+     * @brief Read the current time of the storage holding the queue.
+     * @param now Receives the time stamped on a freshly written file.
+     * @return False if the clock file could not be written.
+     */
+    bool storageNow(std::filesystem::file_time_type& now) const;
+
+    /**
+     * @brief Get the shard file name of a leased path, without the claim token.
+     * @param leased Path of the shard in leased/.
+     * @return The shard file name.
+     */
+    static std::string shardName(const std::filesystem::path& leased);
+
+    /**
+     * @brief Move shards whose lease expired back to pending/.
+     * @return Number of recovered shards.
+     */
+    int recoverExpiredLeases() const;
+
+    /**
+     * @brief Claim one pending shard.
+     * @return Path of the shard in leased/, empty if nothing is pending.
+     */
+    std::filesystem::path claimShard() const;
+
+    /**
+     * @brief Renew the lease of a claimed shard.
+     * @param shard Path of the shard in leased/, including this worker's claim token.
+     * @return False if the lease was lost to another worker.
+     */
+    bool renewLease(const std::filesystem::path& shard) const;
+
+    /**
+     * @brief Run the detectors on every image of a claimed shard that has no results yet.
+     * @param shard Path of the shard in leased/.
+     * @return False if the lease was lost while processing.
+     */
+    bool processShard(const std::filesystem::path& shard) const;
+
+    /**
+     * @brief Count the regular files in a queue subdirectory.
+     * @param name The subdirectory name.
+     * @return The number of files.
+     */
+    size_t countFiles(const std::string& name) const;
+
+public:
+    /**
+     * @brief Constructor that attaches to an existing queue directory.
+     * @param queueDir The queue directory.
+     * @param leaseSeconds Lease time in seconds.
+     * @throws std::runtime_error if the directory is not an initialized queue.
+     */
+    WorkQueue(const std::string& queueDir, int leaseSeconds);
+
+    /**
+     * @brief Create a queue from a manifest of image paths.
+     * @param manifest Text file with one image path per line.
+     * @param queueDir The queue directory to be created.
+     * @param shardSize Number of images per shard.
+     * @return Number of shards written.
+     * @throws std::runtime_error if the manifest cannot be read or the queue already exists.
+     */
+    static int create(const std::string& manifest, const std::string& queueDir, int shardSize);
+
+    /**
+     * @brief Process shards until the queue is drained.
+     *
+     * Returns when nothing is pending and no other worker holds a lease.
+     *
+     * @return Number of shards this worker completed.
+     */
+    int runWorker();
+
+    /**
+     * @brief Print the number of pending, leased and completed shards.
+     * @param os The output stream.
+     */
+    void printStatus(std::ostream& os) const;
+};
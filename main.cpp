@@ -8,32 +8,215 @@
 
 #include "LineDetection.h"
 #include "CornerDetection.h"
+#include "Benchmark.h"
+#include "WorkQueue.h"
+#include "DetectionServer.h"
+#include "DetectionClient.h"
+#include "RegressionHarness.h"
+#include "TaskGraph.h"
+#include "ResultSink.h"
+#include "FeatureFusion.h"
+#include <sstream>
 #include <iostream>
-int main() {
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <algorithm>
+int main(int argc, char* argv[]) {
     try {
         // Specify the file path of the image to be processed.
         std::string imagePath = "color.png";
 
+        // Optional modes selected on the command line.
+        std::string mode = argc > 1 ? argv[1] : "";
+        if (mode == "--benchmark-lines") {
+            // Usage: --benchmark-lines [image] [repetitions]
+            Benchmark::compareLineEngines(argc > 2 ? argv[2] : imagePath, argc > 3 ? std::stoi(argv[3]) : 5, std::cout);
+            return 0;
+        }
+        if (mode == "--benchmark-index") {
+            // Usage: --benchmark-index [features] [queries]
+            return Benchmark::compareSpatialQueries(argc > 2 ? std::stoul(argv[2]) : 1000000, argc > 3 ? std::stoi(argv[3]) : 1000, std::cout) ? 0 : 1;
+        }
+        if (mode == "--benchmark-batch") {
+            // Usage: --benchmark-batch [imagesPerSize] [batchSize]
+            Benchmark::compareMicroBatching(argc > 2 ? std::stoi(argv[2]) : 256, argc > 3 ? std::stoi(argv[3]) : 64, std::cout);
+            return 0;
+        }
+        if (mode == "--benchmark-junctions") {
+            // Usage: --benchmark-junctions [lines] [corners] [repetitions]
+            return Benchmark::compareJunctions(argc > 2 ? std::stoul(argv[2]) : 20000, argc > 3 ? std::stoul(argv[3]) : 5000,
+                argc > 4 ? std::stoi(argv[4]) : 3, std::cout) ? 0 : 1;
+        }
+        if (mode == "--check-denoise") {
+            // Usage: --check-denoise <tolerance> <image>...
+            double tolerance = argc > 2 ? std::stod(argv[2]) : 3.0;
+            std::vector<std::string> images(argv + std::min(argc, 3), argv + argc);
+            if (images.empty()) {
+                images.push_back(imagePath);
+            }
+            return Benchmark::compareDenoisers(images, tolerance, 0.8, std::cout) ? 0 : 1;
+        }
+        if (mode == "--queue-init" && argc > 3) {
+            // Usage: --queue-init <manifest> <queueDir> [shardSize]
+            int shards = WorkQueue::create(argv[2], argv[3], argc > 4 ? std::stoi(argv[4]) : 16);
+            std::cout << "Work queue created with " << shards << " shards: " << argv[3] << std::endl;
+            return 0;
+        }
+        if (mode == "--queue-work" && argc > 2) {
+            // Usage: --queue-work <queueDir> [leaseSeconds]
+            WorkQueue queue(argv[2], argc > 3 ? std::stoi(argv[3]) : 120);
+            int completed = queue.runWorker();
+            std::cout << "Shards completed by this worker: " << completed << std::endl;
+            return 0;
+        }
+        if (mode == "--queue-status" && argc > 2) {
+            WorkQueue(argv[2], 120).printStatus(std::cout);
+            return 0;
+        }
+        if (mode == "--daemon" && argc > 2) {
+            // Usage: --daemon <socketPath> [workers] [maxPayloadMiB]
+            DetectionServer server(argv[2], argc > 3 ? std::stoi(argv[3]) : 0, (argc > 4 ? std::stoul(argv[4]) : 64) << 20);
+            server.run();
+            return 0;
+        }
+        if (mode == "--client" && argc > 4) {
+            // Usage: --client <socketPath> <lines|corners|both> <image> [key=value ...]
+            std::string parameters;
+            for (int i = 5; i < argc; ++i) {
+                parameters += (parameters.empty() ? "" : " ") + std::string(argv[i]);
+            }
+            std::ifstream imageFile(argv[4], std::ios::binary);
+            std::vector<unsigned char> imageBytes((std::istreambuf_iterator<char>(imageFile)), std::istreambuf_iterator<char>());
+
+            DetectionClient client(argv[2]);
+            std::vector<std::string> response;
+            bool ok = client.detectBytes(argv[3], imageBytes, parameters, response);
+            for (const std::string& line : response) {
+                std::cout << line << "\n";
+            }
+            return ok ? 0 : 1;
+        }
+        if (mode == "--loadtest" && argc > 3) {
+            // Usage: --loadtest <socketPath> <image> [concurrency] [requestsPerClient] [lines|corners|both]
+            DetectionClient::runLoadTest(argv[2], argv[3], argc > 6 ? argv[6] : "both",
+                argc > 4 ? std::stoi(argv[4]) : 4, argc > 5 ? std::stoi(argv[5]) : 25, std::cout);
+            return 0;
+        }
+        if (mode == "--regression") {
+            // Usage: --regression [manifest|-] [mode,mode,...|all] [tolerance] [minAccuracy] [repetitions]
+            RegressionHarness harness(argc > 4 ? std::stod(argv[4]) : 2.0, argc > 5 ? std::stod(argv[5]) : 0.9,
+                argc > 6 ? std::stoi(argv[6]) : 3);
+            if (argc > 2 && std::string(argv[2]) != "-") {
+                harness.loadManifest(argv[2]);
+            }
+            else {
+                harness.addCase(imagePath, "lines_features.txt", "corners_features.txt");
+            }
+
+            std::vector<std::string> modeNames;
+            std::istringstream modeList(argc > 3 && std::string(argv[3]) != "all" ? argv[3] : "");
+            for (std::string name; std::getline(modeList, name, ',');) {
+                modeNames.push_back(name);
+            }
+            return harness.run(modeNames, std::cout) ? 0 : 1;
+        }
+        if (mode == "--stream" && argc > 4) {
+            // Usage: --stream <ndjson|csv> <summary|features|detailed> <image>...
+            ResultSink sink(std::cout, ResultSink::parseFormat(argv[2]), ResultSink::parseVerbosity(argv[3]));
+            int failed = 0;
+            for (int i = 4; i < argc; ++i) {
+                const std::string streamImage = argv[i];
+                // A bad image gets an error record instead of ending the stream.
+                try {
+                    LineDetection streamLines(streamImage);
+                    CornerDetection streamCorners(streamLines.getOrginalPic());
+                    streamLines.setLeanMode(true);
+                    streamCorners.setLeanMode(true);
+                    streamLines.prepare();
+                    streamCorners.adoptPreprocessing(streamLines);
+                    streamLines.analyzeFeatures();
+                    streamCorners.analyzeFeatures();
+                    sink.submit(streamImage, &streamLines, &streamCorners);
+                }
+                catch (const std::exception& e) {
+                    sink.submitError(streamImage, e.what());
+                    ++failed;
+                }
+            }
+            sink.close();
+            return failed > 0 ? 1 : 0;
+        }
+        if (mode == "--budget") {
+            // Usage: --budget <milliseconds> [image]
+            double budget = argc > 2 ? std::stod(argv[2]) : 50.0;
+            std::string budgetImage = argc > 3 ? argv[3] : imagePath;
+
+            LineDetection budgetLines(budgetImage);
+            CornerDetection budgetCorners(budgetImage);
+            budgetLines.setLatencyBudget(budget);
+            budgetCorners.setLatencyBudget(budget);
+
+            // Startup probe, keeps the calibration out of the measured latency.
+            budgetLines.calibrateCostModel();
+            budgetCorners.calibrateCostModel();
+
+            budgetLines.analyzeFeatures();
+            budgetCorners.analyzeFeatures();
+
+            const Detection* detectors[] = { &budgetLines, &budgetCorners };
+            const char* names[] = { "Lines", "Corners" };
+            for (int i = 0; i < 2; ++i) {
+                const ProcessingReport& report = detectors[i]->getProcessingReport();
+                std::cout << names[i] << ": " << report.originalSize.width << "x" << report.originalSize.height
+                    << " -> " << report.workingSize.width << "x" << report.workingSize.height
+                    << ", budget " << report.budgetMs << " ms, predicted " << report.predictedMs
+                    << " ms, spent " << report.elapsedMs << " ms, features " << detectors[i]->getanalyzeFeatures().size() << "\n";
+            }
+            return 0;
+        }
+
         // Create instances of LineDetection and CornerDetection classes and associate them with the input image.
         LineDetection lineDetection(imagePath);
         CornerDetection cornerDetection(imagePath);
 
-        // Perform line detection operations
-        lineDetection.analyzeFeatures();
+        // Preprocess once, then run both detectors, the file outputs and the merge as dependent tasks.
+        cv::Mat combinedImage;
+        TaskGraph pipeline;
+        size_t preprocess = pipeline.add("preprocess", [&]() {
+            lineDetection.prepare();
+            cornerDetection.adoptPreprocessing(lineDetection);
+        });
+        size_t lines = pipeline.add("detect lines", [&]() { lineDetection.analyzeFeatures(); }, { preprocess });
+        size_t corners = pipeline.add("detect corners", [&]() { cornerDetection.analyzeFeatures(); }, { preprocess });
+        pipeline.add("write lines", [&]() {
+            lineDetection.writeFeaturesToFile("lines_features.txt");
+            lineDetection.saveOutputImage("lines_output.png");
+        }, { lines });
+        pipeline.add("write corners", [&]() {
+            cornerDetection.writeFeaturesToFile("corners_features.txt");
+            cornerDetection.saveOutputImage("corners_output.png");
+        }, { corners });
+        pipeline.add("junctions", [&]() {
+            std::vector<Junction> junctions = FeatureFusion::extractJunctions(lineDetection, cornerDetection, 5.0f);
+            FeatureFusion::writeJunctionsToFile(junctions, "junctions_features.txt");
+        }, { lines, corners });
+        pipeline.add("merge", [&]() {
+            combinedImage = Detection::renderCombined(lineDetection, cornerDetection);
+            cv::imwrite("merged_features.png", combinedImage);
+        }, { lines, corners });
+        pipeline.run(TaskExecutor::shared());
+
+        // Results and windows stay on the main thread.
         std::cout << "\nLine Detection Results:\n" << lineDetection;
         lineDetection.plotFeatures();
-        lineDetection.writeFeaturesToFile("lines_features.txt");
-        lineDetection.saveOutputImage("lines_output.png");
-
-        // Perform corner detection operations
-        cornerDetection.analyzeFeatures();
         std::cout << "\nCorner Detection Results:\n" << cornerDetection;
         cornerDetection.plotFeatures();
-        cornerDetection.writeFeaturesToFile("corners_features.txt");
-        cornerDetection.saveOutputImage("corners_output.png");
 
         // Show line and corner plot
-        lineDetection.combineLineAndCornerPlot();
+        cv::imshow("Combined Features", combinedImage);
+        cv::waitKey(0);
 
     }
     catch (const std::exception& ex) {